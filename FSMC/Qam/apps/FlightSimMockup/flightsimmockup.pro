@@ -45,6 +45,9 @@ include(../../libs/QamWidgets/qamled.pri)
 include(../../libs/QamSockets/qamsockets.pri)
 include(../../libs/QamModbusMap/qammodbusmap.pri)
 
+# Qam6Dof library (header-only)
+include(../../libs/Qam6Dof/qam6dof.pri)
+
 SOURCES += \
     fsmucollective.cpp \
     fsmuconsole.cpp \
@@ -53,11 +56,11 @@ SOURCES += \
     fsmuseat.cpp \
 	main.cpp\
     mainwindow.cpp \
-	qam6dof.cpp \
     flightsimmockup.cpp \ 
     fsmuframe.cpp \
 	hexapod.cpp \
-    hexapodconfigurator.cpp
+    hexapodconfigurator.cpp \
+    hexapodmgdsolver.cpp
 
 
 HEADERS  += \
@@ -67,11 +70,11 @@ HEADERS  += \
     fsmurudder.h \
     fsmuseat.h \
 	mainwindow.h \
-	qam6dof.h \
 	flightsimmockup.h \
     fsmuframe.h \
 	hexapod.h \
-    hexapodconfigurator.h
+    hexapodconfigurator.h \
+    hexapodmgdsolver.h
 
 
 FORMS    += mainwindow.ui
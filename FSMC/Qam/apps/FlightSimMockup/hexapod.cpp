@@ -25,6 +25,7 @@
  */
 
 #include "hexapod.h"
+#include <cmath>
 
 #ifdef QAMDEBUG
 	#include <QDebug>
@@ -42,6 +43,7 @@ Hexapod::Hexapod()
 	, m_pDec(  40 )
     ,*/ m_base( 0 )
 	, m_platine( 0 )
+	, m_mgdSync( false )
 {
     setData(HexapodData());
 	m_vKin.fill( 0.0 ) ;
@@ -278,6 +280,17 @@ void Hexapod::setGeometry()
 		m_pAncRef[i] = m_pAnc[i] ;
 	}
 
+	// solveur MGD
+	float bx[6], by[6], px[6], py[6] ;
+	for ( int i = 0 ; i < 6 ; ++i ) {
+		bx[i] = m_bAnc[i].x() ;
+		by[i] = m_bAnc[i].y() ;
+		px[i] = m_pAncRef[i].x() ;
+		py[i] = m_pAncRef[i].y() ;
+	}
+	m_mgd.setGeometry( bx, by, m_pMinAlt, px, py ) ;
+	m_mgdSync = false ;
+
 	// pivot virtuel
 	m_pPiv = QVector3D( 0.0,  0.0, 0.0 ) ;
 
@@ -307,6 +320,7 @@ float Hexapod::vlength(int i )
 void Hexapod::resetPosition()
 {
 	m_vKin.fill( 0.0 ) ;
+	m_mgdSync = false ;
 	setMatrix_MGI() ;
 }
 
@@ -315,99 +329,44 @@ void Hexapod::resetPosition()
 void Hexapod::setMgi(const QamMatrix6x1& kin )
 {
 	m_vKin = kin ;
+	m_mgdSync = false ;
 	setMatrix_MGI() ;
 }
 
 // MGD : modification des longueurs des vérins
+// pose de départ : dernières solutions du solveur, ou pose courante si elle
+// a été modifiée par le MGI (ordre des inconnues : Tx,Ty,Tz, Rz,Rx,Ry)
 
 void Hexapod::setMgd(const QamMatrix6x1& len )
 {
-	bool err = false ;
-	QamMatrix6x1 kin = newtonRaphson(m_vKin.toRadians(), len, err ).toDegrees() ;
-
-	if ( err )	return ;
-
-	m_vKin = kin ;
-	setMatrix_MGD() ;
-}
-
-
-// -----------------------------------------------------------------------
-// fonction objectif de l'algorithme de Newton-Raphson
-// affecte les membres _tf et _jac
-// kin :	vecteur des inconnues Tx,Ty,Tz,Rx,Ry,Rz		(mm/radians)
-// len :	vecteur des longueurs des vérins			(mm)
-
-void Hexapod::targetFunct(const QamMatrix6x1& kin, const QamMatrix6x1& len )
-{
-	float c1 = COS( kin(3) ) ;	float s1 = SIN( kin(3) ) ;
-	float c2 = COS( kin(4) ) ;	float s2 = SIN( kin(4) ) ;
-	float c3 = COS( kin(5) ) ;	float s3 = SIN( kin(5) ) ;
-
-	for ( int i = 0 ; i < 6 ; ++i ) {
-		float x = -m_bRay * _cA(i) + kin(0) + m_pRay * ( _cB(i) * (c3*c1-s3*s2*s1) + _sB(i) * (-c2*s1) )  ;
-		float y = -m_bRay * _sA(i) + kin(1) + m_pRay * ( _cB(i) * (c3*s1+s3*s2*c1) + _sB(i) * ( c2*c1) )  ;
-		float z =  m_pMinAlt       + kin(2) + m_pRay * ( _cB(i) * (-s3*c2) + _sB(i) * s2 ) ;
-		_tf(i) = qPow(x, 2 ) + qPow(y, 2 ) + qPow(z, 2 ) - qPow(len(i), 2 ) ;
-		_jac(i,0) =  2 * x ;
-		_jac(i,1) =  2 * y ;
-		_jac(i,2) =  2 * z ;
-		_jac(i,3) =  2 * m_pRay * (( _cB(i)*(-c3*s1-s3*s2*c1) - _sB(i)*c2*c1) * x + (_cB(i)*(c3*c1-s3*s2*s1) - _sB(i)*c2*s1) * y ) ;
-		_jac(i,4) =  2 * m_pRay * ((-_cB(i)*s3*c2*s1 + _sB(i)*s2*s1) * x + (_cB(i) * s3*c2*s1 - _sB(i)*s2*c1) * y + (_cB(i)*s3*s2 + _sB(i)*c2) * z ) ;
-		_jac(i,5) = -2 * m_pRay *    _cB(i)*(c3*c2) * z ;
+	if ( !m_mgdSync ) {
+		float start[6] = { m_vKin(0), m_vKin(1), m_vKin(2),
+						   qDegreesToRadians( m_vKin(5) ),
+						   qDegreesToRadians( m_vKin(3) ),
+						   qDegreesToRadians( m_vKin(4) ) } ;
+		m_mgd.setStart( start ) ;
+		m_mgdSync = true ;
 	}
 
-	_tf  /= qPow(m_pMinAlt, 2 ) ;
-	_jac /= qPow(m_pMinAlt, 2 ) ;
-}
-
-// -----------------------------------------------------------------------
-// schéma de Newton-Raphson
-// utilise les membres _tf et _jac affectés par targetFunct()
-//
-// kin :	vecteur conditions initiales Tx,Ty,Tz,Rx,Ry,Rz	(mm/radians)
-// len :	vecteur des longueurs des vérins				(mm)
-
-QamMatrix6x1 Hexapod::newtonRaphson(const QamMatrix6x1& kin, const QamMatrix6x1& len, bool& err )
-{
-    int				imax = 50 ;		// nombre max. d'itérations
-	qreal			eps = 10e-6 ;	// seuil de convergence
-	QamMatrix6x1	res = kin ;
-
-	for ( int i = 0 ; i <= imax ; ++i ) {
-
-		targetFunct(res, len ) ;
-
-		if ( _tf.norm() <= eps ) {	// issue attendue...
-			err = false ;
-//			qDebug() << "NR ok, i=" << i ;
-			break ;
-		}
-		else if ( i >= imax ) {
-			err = true ;
-			qDebug() << "pb de convergence" ;
-			break ;
-		}
-		else {						// itération...
-			QamMatrix6x6 m = _jac ;
-			m.inverted() ;
-			QamMatrix1x6 nx = res.toColumn() ;
-			nx -= m.mult( _tf ) ;
-			res = nx.toRow() ;
-		}
+	float x[6] ;
+	if ( !m_mgd.solve( len.constData(), x ) ) {
+#ifdef QAMDEBUG
+		qDebug() << "pb de convergence, résidu" << m_mgd.diagnostics().residual ;
+#endif
+		return ;
 	}
 
 	// modulo 2PI sur les angles de rotation
-	for ( int i = 3 ; i < 6 ; ++i ) {
-		int sign = ( res(i) > 0 ? 1 : -1 ) ;
-		while ( qAbs( res(i) ) > 2 * M_PI )	res(i) -= sign * 2 * M_PI ;
-	}
+	for ( int i = 3 ; i < 6 ; ++i )	x[i] = std::fmod( x[i], 2 * M_PI ) ;
 	// Tz négatif interdit !
-	if ( res(2) < 0 )	res(2) = 0 ;
+	if ( x[2] < 0 )	x[2] = 0 ;
 
-	return res ;
+	m_vKin.set( x ) ;
+	m_vKin.convertToDegrees() ;
+	setMatrix_MGD() ;
 }
 
+
 // détermination des matrices 3D après modif. m_vKin par Newton-Raphson
 
 void Hexapod::setMatrix_MGD()
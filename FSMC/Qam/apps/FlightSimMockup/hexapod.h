@@ -30,6 +30,8 @@
 #include <GLamObjects>
 #include <glamtext.h>
 #include <qam6dof.h>
+#include <QtMath>
+#include "hexapodmgdsolver.h"
 
 // Hexapode (plateforme de Stewart)
 // ----------------------------------------------------------------------------
@@ -113,12 +115,13 @@ class Hexapod
 
 	// translations / rotations	[Tx, Ty, Tz, Rx, Ry, Rz]
 	void resetPosition() ;
-	QamMatrix6x1 mgi() const { return m_vKin ; }
+	const QamMatrix6x1& mgi() const { return m_vKin ; }
 	void setMgi(const QamMatrix6x1& kin ) ;
 
 	// longueurs des actuateurs [L0, L1, L2, L3, L4, L5]
-	QamMatrix6x1 mgd() const { return m_vLen ; }
+	const QamMatrix6x1& mgd() const { return m_vLen ; }
 	void setMgd(const QamMatrix6x1& len ) ;
+	const HexapodMgdSolver& mgdSolver() const { return m_mgd ; }	// new v0.12
 
 	// matrice de transformation de la platine
 	QMatrix4x4 transformMatrix() const { return m_mKinMockup ; }
@@ -169,13 +172,10 @@ class Hexapod
 	QMatrix4x4		m_mKinMockup ;
 	QVector3D		m_pPiv ;		// pivot virtuel platine
 
-	// Newton-Raphson
+	// MGD (Newton-Raphson)												new v0.12
 
-	QamMatrix1x6	_tf ;
-	QamMatrix6x6	_jac ;
-
-	void targetFunct(const QamMatrix6x1& kin, const QamMatrix6x1& len ) ;
-	QamMatrix6x1 newtonRaphson(const QamMatrix6x1& kin, const QamMatrix6x1& len, bool& err ) ;
+	HexapodMgdSolver	m_mgd ;
+	bool				m_mgdSync ;	// faux si m_vKin modifié hors MGD
 
 	void setMatrix_MGD() ;		// ui --> longueur des vérin(s)
 	void setMatrix_MGI() ;		// ui --> translations/rotations
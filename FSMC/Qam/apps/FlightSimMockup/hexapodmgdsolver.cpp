@@ -0,0 +1,194 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   hexapodmgdsolver.cpp
+ *  description :   IMPLEMENTATION de la classe HexapodMgdSolver
+ *
+ *	project     :	Scène 3D LLF Maquette éch. 1:1 FlightSim
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2017-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "FlightSim Mock-up"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#include "hexapodmgdsolver.h"
+#include <cmath>
+
+HexapodMgdSolver::HexapodMgdSolver()
+	: m_az( 0 )
+	, m_scale( 1 )
+	, m_maxIter( MGD_MAX_ITERATIONS )
+	, m_tol( MGD_TOLERANCE )
+	, m_history( 0 )
+{
+	for ( int i = 0 ; i < 6 ; ++i ) {
+		m_ax[i] = m_ay[i] = m_ux[i] = m_uy[i] = 0 ;
+		m_x[i] = m_xPrev[i] = 0 ;
+	}
+	m_diag.status = Converged ;
+	m_diag.iterations = 0 ;
+	m_diag.halvings = 0 ;
+	m_diag.residual = 0 ;
+	m_diag.predicted = false ;
+}
+
+// -----------------------------------------------------------------------
+// géométrie : ancrages base fixe (altitude -minAlt) et platine au repos
+// (altitude 0) ; l'historique des solutions est effacé
+
+void HexapodMgdSolver::setGeometry(const float* baseX, const float* baseY, float minAlt, const float* topX, const float* topY )
+{
+	for ( int i = 0 ; i < 6 ; ++i ) {
+		m_ax[i] = -baseX[i] ;
+		m_ay[i] = -baseY[i] ;
+		m_ux[i] = topX[i] ;
+		m_uy[i] = topY[i] ;
+	}
+	m_az = minAlt ;
+	m_scale = 1.0 / ( (double)minAlt * minAlt ) ;
+	m_history = 0 ;
+}
+
+// point de départ imposé (pose connue par ailleurs, MGI par exemple)
+
+void HexapodMgdSolver::setStart(const float* x )
+{
+	for ( int i = 0 ; i < 6 ; ++i )	m_x[i] = x[i] ;
+	m_history = 1 ;
+}
+
+// -----------------------------------------------------------------------
+// calcul MGD
+// len :	longueurs des 6 vérins						(mm)
+// x :		solution Tx,Ty,Tz,A1,A2,A3, inchangée en cas d'échec	(mm/radians)
+// retourne vrai si le résidu est sous le seuil de convergence
+
+bool HexapodMgdSolver::solve(const float* len, float* x )
+{
+	Qam6Vectord	cur ;
+	Qam6Vectord	dx ;
+	Qam6Vectord	trial ;
+
+	for ( int i = 0 ; i < 6 ; ++i )	m_len2[i] = (double)len[i] * len[i] ;
+
+	// départ : dernière solution, ou extrapolation si plus proche
+
+	if ( m_history )	cur.set( m_x ) ;
+
+	m_diag.predicted = false ;
+	if ( m_history == 2 ) {
+		for ( int i = 0 ; i < 6 ; ++i )	trial(i) = 2 * m_x[i] - m_xPrev[i] ;
+		if ( evaluate( trial, false ) < evaluate( cur, false ) ) {
+			cur = trial ;
+			m_diag.predicted = true ;
+		}
+	}
+
+	m_diag.iterations = 0 ;
+	m_diag.halvings = 0 ;
+
+	for ( int it = 0 ; ; ++it ) {
+
+		double res = evaluate( cur, true ) ;
+		m_diag.residual = res ;
+
+		if ( res <= m_tol ) {						// issue attendue...
+			m_diag.status = Converged ;
+			break ;
+		}
+		if ( it >= m_maxIter ) {
+			m_diag.status = MaxIterations ;
+			return false ;
+		}
+		if ( !m_jac.decompose( m_perm, MGD_MIN_PIVOT ) ) {
+			m_diag.status = Singular ;
+			return false ;
+		}
+
+		dx = m_f ;
+		m_jac.substitute( m_perm, dx ) ;			// J.dx = f
+
+		// pas amorti : divisé par 2 tant que le résidu ne décroît pas
+
+		double lambda = 1.0 ;
+		for ( int h = 0 ; ; ++h ) {
+			trial.assignAxpy( cur, -lambda, dx ) ;
+			if (( evaluate( trial, false ) < res )||( h >= MGD_MAX_HALVINGS ))	break ;
+			lambda *= 0.5 ;
+			m_diag.halvings++ ;
+		}
+		cur = trial ;
+		m_diag.iterations++ ;
+	}
+
+	// historique pour le départ du calcul suivant
+
+	for ( int i = 0 ; i < 6 ; ++i ) {
+		m_xPrev[i] = m_x[i] ;
+		m_x[i] = cur(i) ;
+		x[i] = cur(i) ;
+	}
+	if ( m_history < 2 )	m_history++ ;
+
+	return true ;
+}
+
+// -----------------------------------------------------------------------
+// [private] fonction objectif en x : affecte m_f (et m_jac si demandé)
+// retourne la norme du résidu
+
+double HexapodMgdSolver::evaluate(const Qam6Vectord& x, bool withJacobian )
+{
+	const double c1 = std::cos( x(3) ), s1 = std::sin( x(3) ) ;
+	const double c2 = std::cos( x(4) ), s2 = std::sin( x(4) ) ;
+	const double c3 = std::cos( x(5) ), s3 = std::sin( x(5) ) ;
+
+	// colonnes 0 et 1 de R = Rz(A1).Rx(A2).Ry(A3) (ancrages platine en z = 0)
+	const double r0x = c1*c3 - s1*s2*s3,	r0y = s1*c3 + c1*s2*s3,	r0z = -c2*s3 ;
+	const double r1x = -s1*c2,				r1y = c1*c2,			r1z = s2 ;
+
+	double norm = 0 ;
+
+	for ( int i = 0 ; i < 6 ; ++i ) {
+		const double vx = m_ax[i] + x(0) + m_ux[i] * r0x + m_uy[i] * r1x ;
+		const double vy = m_ay[i] + x(1) + m_ux[i] * r0y + m_uy[i] * r1y ;
+		const double vz = m_az    + x(2) + m_ux[i] * r0z + m_uy[i] * r1z ;
+
+		m_f(i) = ( vx*vx + vy*vy + vz*vz - m_len2[i] ) * m_scale ;
+		norm += m_f(i) * m_f(i) ;
+
+		if ( !withJacobian )	continue ;
+
+		const double k = 2 * m_scale ;
+		const double ux = m_ux[i], uy = m_uy[i] ;
+
+		m_jac(i,0) = k * vx ;
+		m_jac(i,1) = k * vy ;
+		m_jac(i,2) = k * vz ;
+		// dV/dA1
+		m_jac(i,3) = k * ( vx * ( ux * (-s1*c3 - c1*s2*s3) + uy * (-c1*c2) )
+						 + vy * ( ux * ( c1*c3 - s1*s2*s3) + uy * (-s1*c2) ) ) ;
+		// dV/dA2
+		m_jac(i,4) = k * ( vx * ( ux * (-s1*c2*s3) + uy * ( s1*s2) )
+						 + vy * ( ux * ( c1*c2*s3) + uy * (-c1*s2) )
+						 + vz * ( ux * ( s2*s3)    + uy * c2 ) ) ;
+		// dV/dA3
+		m_jac(i,5) = k * ux * ( vx * (-c1*s3 - s1*s2*c3)
+							  + vy * (-s1*s3 + c1*s2*c3)
+							  + vz * (-c2*c3) ) ;
+	}
+	return std::sqrt( norm ) ;
+}
@@ -0,0 +1,105 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   hexapodmgdsolver.h
+ *  description :   INTERFACE de la classe HexapodMgdSolver
+ *
+ *	project     :	Scène 3D LLF Maquette éch. 1:1 FlightSim
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2017-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "FlightSim Mock-up"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#ifndef HEXAPODMGDSOLVER_H
+#define HEXAPODMGDSOLVER_H
+
+#include <qam6dof.h>
+
+// Solveur MGD (longueurs des vérins --> pose de la platine)
+// ----------------------------------------------------------------------------
+// inconnues : x = [ Tx,Ty,Tz, A1,A2,A3 ] (mm/radians), rotation de la platine
+//             R = Rz(A1).Rx(A2).Ry(A3) (modèle de Hexapod::setMatrix_MGD())
+// équations : f(i) = ( |V(i)|^2 - L(i)^2 ) / Zmin^2, V(i) vecteur vérin n°i
+// schéma :    Newton-Raphson, Jacobienne analytique, système 6x6 résolu par
+//             décomposition LU à pivot partiel (Qam6Matrixd), pas amorti (divisé par 2 tant
+//             que le résidu ne décroît pas), nombre d'itérations borné
+// départ :    extrapolation linéaire des deux dernières solutions, ou dernière
+//             solution si son résidu est meilleur
+// mémoire :   tableaux de taille fixe, aucune allocation par appel
+// ----------------------------------------------------------------------------
+
+#define	MGD_MAX_ITERATIONS	12		// nombre max. d'itérations
+#define	MGD_TOLERANCE		1e-5	// seuil de convergence (norme du résidu)
+#define	MGD_MAX_HALVINGS	4		// réductions max. du pas par itération
+#define	MGD_MIN_PIVOT		1e-12	// pivot minimal (Jacobienne singulière)
+
+class HexapodMgdSolver
+{
+  public:
+	// bilan du dernier appel à solve()
+	typedef enum { Converged, MaxIterations, Singular } Status ;
+
+	struct Diagnostics {
+		Status	status ;
+		int		iterations ;	// itérations de Newton effectuées
+		int		halvings ;		// réductions de pas cumulées
+		double	residual ;		// norme finale du résidu
+		bool	predicted ;		// départ par extrapolation
+	} ;
+
+	HexapodMgdSolver() ;
+
+	void setGeometry(const float* baseX, const float* baseY, float minAlt, const float* topX, const float* topY ) ;
+	void setStart(const float* x ) ;
+	void setMaxIterations(int n ) { m_maxIter = n ; }
+	void setTolerance(double tol ) { m_tol = tol ; }
+
+	bool solve(const float* len, float* x ) ;
+
+	const Diagnostics& diagnostics() const { return m_diag ; }
+
+  private:
+	double evaluate(const Qam6Vectord& x, bool withJacobian ) ;
+
+  private:
+	// géométrie : ancrages base (a) et platine au repos (u)
+	double		m_ax[6] ;
+	double		m_ay[6] ;
+	double		m_az ;			// altitude platine au repos (vérins rentrés)
+	double		m_ux[6] ;
+	double		m_uy[6] ;
+	double		m_scale ;		// 1 / Zmin^2
+
+	// réglages
+	int			m_maxIter ;
+	double		m_tol ;
+
+	// espace de travail
+	double		m_len2[6] ;		// L(i)^2
+	Qam6Vectord	m_f ;			// résidu
+	Qam6Matrixd	m_jac ;			// Jacobienne, puis facteurs L et U
+	int			m_perm[6] ;		// permutation des lignes
+
+	// historique des solutions (départ du calcul suivant)
+	double		m_x[6] ;		// dernière solution
+	double		m_xPrev[6] ;	// avant-dernière solution
+	int			m_history ;		// solutions disponibles (0..2)
+
+	Diagnostics	m_diag ;
+} ;
+
+#endif // HEXAPODMGDSOLVER_H
@@ -32,6 +32,9 @@ MainWindow::MainWindow(QWidget* parent )
 	, m_hexapod( 0 )
 	, m_hexapodConfigurator( 0 )
     , m_tcpClient( 0 )
+    , m_poseGroup( -1 )
+    , m_push( 0 )
+    , m_pushClient( 0 )
     , m_mode( JOG )
 {
     // scène 3D et son inteface de pilotage
@@ -320,6 +323,24 @@ void MainWindow::loadCsv_clicked()
 
         m_modbusMap->loadMap( fileName ) ;
 
+        // registres de pose lus par plages (une requête FC3 par plage)
+        m_poseGroup = m_modbusMap->addPollGroup(QamModbusMap::HoldingRegister,
+                            QStringList() << "Tx" << "Ty" << "Tz" << "Rx" << "Ry" << "Rz" ) ;
+
+        // abonnement aux mêmes registres sur le canal de notification, s'il
+        // est servi : la scrutation n'est alors plus nécessaire
+        m_push = new QamModbusPushClient(m_modbusMap, this ) ;
+        quint16 first = 0xFFFF ;
+        quint16 last = 0 ;
+        foreach ( QString name, QStringList() << "Tx" << "Ty" << "Tz" << "Rx" << "Ry" << "Rz" ) {
+            QamModbusMap::Handle h = m_modbusMap->handle(QamModbusMap::HoldingRegister, name ) ;
+            if ( !h.isValid() )    continue ;
+            first = qMin( first, h.address ) ;
+            last = qMax( last, (quint16)( h.address + h.words ) ) ;
+        }
+        if ( last > first )    m_push->subscribe(QamModbusMap::HoldingRegister, first, last - first ) ;
+        m_pushClient = new QamTcpClient(m_push, this ) ;
+
         m_edtServer->setText( QString("%1:%2").arg(m_modbusMap->host()).arg(m_modbusMap->port()) ) ;
 
         m_btnModbusConnect->setEnabled( true ) ;
@@ -340,6 +361,7 @@ void MainWindow::modbusConnect_clicked()
         if ( m_mode == AUTO )   modbusRun_clicked() ;
         //
         m_tcpClient->sockClose() ;
+        m_pushClient->sockClose() ;
         m_btnModbusRun->setText("Run") ;
         connected = false ;
     }
@@ -350,6 +372,8 @@ void MainWindow::modbusConnect_clicked()
         m_tcpClient->sockConnect(host, port ) ;
         if ( m_tcpClient->waitForConnected(3000) ) {
             connected = true ;
+            // canal de notification facultatif (sans attente)
+            m_pushClient->sockConnect(host, port + MODBUSPUSH_PORT_OFFSET ) ;
         }
         else {
             //info("tcp/ip", "Connection failed!" ) ;
@@ -402,15 +426,22 @@ void MainWindow::getRemoteMgi()
     static unsigned autoCount = 0 ;
 
     QamMatrix6x1    kin ;
-    QamModbusMap::PrimaryTable  table = QamModbusMap::HoldingRegister ;
 
-    // lecture des registres
-    kin(0) =  m_modbusMap->value(table, "Tx" ).toFloat();
-    kin(1) =  m_modbusMap->value(table, "Ty" ).toFloat();
-    kin(2) =  m_modbusMap->value(table, "Tz" ).toFloat();
-    kin(3) =  m_modbusMap->value(table, "Rx" ).toFloat()/100 ;
-    kin(4) =  m_modbusMap->value(table, "Ry" ).toFloat()/100 ;
-    kin(5) =  m_modbusMap->value(table, "Rz" ).toFloat()/100 ;
+    // lecture des registres : une requête asynchrone par plage couvrante du
+    // groupe, les valeurs utilisées sont celles de la cartographie locale,
+    // actualisées par les réponses du cycle précédent ; si le canal de
+    // notification est connecté, la cartographie est tenue à jour par le
+    // serveur et aucune requête n'est émise
+    float   pose[PoseSize] ;
+    if ( !m_push->isAvailable() )   m_modbusMap->pollRemote( m_poseGroup ) ;
+    if ( !m_modbusMap->pollValues( m_poseGroup, pose ) )    return ;
+
+    kin(0) =  pose[PoseTx] ;
+    kin(1) =  pose[PoseTy] ;
+    kin(2) =  pose[PoseTz] ;
+    kin(3) =  pose[PoseRx] / 100 ;
+    kin(4) =  pose[PoseRy] / 100 ;
+    kin(5) =  pose[PoseRz] / 100 ;
     /*
     kin(0) =  m_modbusMap->value(table, "Tx" ).toFloat() ;
     kin(1) =  m_modbusMap->value(table, "Ty" ).toFloat() ;
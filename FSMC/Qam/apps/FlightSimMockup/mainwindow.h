@@ -51,6 +51,10 @@ class MainWindow : public QMainWindow , private Ui::MainWindow
 //	~MainWindow() { delete m_glamWidget ; }
 	//
     enum Mode { JOG, CONNECT, DEMO, AUTO } ;
+
+    // rangs de la pose lue sur le serveur Modbus (ordre de déclaration du
+    // groupe) : Tx, Ty, Tz en mm, Rx, Ry, Rz en 1/100 degré
+    enum RemotePose { PoseTx, PoseTy, PoseTz, PoseRx, PoseRy, PoseRz, PoseSize } ;
     // JOG : configuration, MGD
     // CONNECT : JOG + connexion serveur modbus (accès R/W configuration)
     // DEMO : animation locale rotation(s) (MGI)
@@ -132,6 +136,9 @@ class MainWindow : public QMainWindow , private Ui::MainWindow
     QString         m_configDir ;       // new v0.7
     QamModbusMap*	m_modbusMap ;
     QamTcpClient*	m_tcpClient ;
+    int             m_poseGroup ;       // new v0.10 : groupe de scrutation Tx..Rz
+    QamModbusPushClient*    m_push ;    // new v0.11 : canal de notification Tx..Rz
+    QamTcpClient*	m_pushClient ;
 
     Mode            m_mode ;
 } ;
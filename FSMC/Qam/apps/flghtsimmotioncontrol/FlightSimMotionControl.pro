@@ -10,6 +10,7 @@ CONFIG += c++11
 
 include(../../libs/QamSockets/qamsockets.pri)
 include(../../libs/QamModbusMap/qammodbusmap.pri)
+include(../../libs/Qam6Dof/qam6dof.pri)
 
 SOURCES += \
     main.cpp \
@@ -19,9 +20,13 @@ SOURCES += \
     #qammodbusmap.cpp \
     #qamtcpconnection.cpp \
     #qamtcpserver.cpp \
+    hexapodik.cpp \
     hexapodmgi.cpp\
-    qam6dof.cpp \
-    trdatagram.cpp
+    hexapodratelimiter.cpp \
+    hexapodworkspace.cpp \
+    trdatagram.cpp \
+    xplanedatagram.cpp \
+    xplanereceiver.cpp
 
 HEADERS += \
     modipslave.h \
@@ -30,9 +35,14 @@ HEADERS += \
     #qammodbusmap.h \
     #qamtcpconnection.h \
     #qamtcpserver.h \
+    hexapodik.h \
     hexapodmgi.h\
-    qam6dof.h \
-    trdatagram.h
+    hexapodratelimiter.h \
+    hexapodworkspace.h \
+    trdatagram.h \
+    xplanedatagram.h \
+    xplanedatarefs.h \
+    xplanereceiver.h
 
 FORMS += \
     trdatagram.ui
@@ -54,5 +64,8 @@ RCC_DIR		= .uic
 MOC_DIR		= .moc
 OBJECTS_DIR	= .obj
 
+# MGI : racines carrées vectorisables (HexapodIK)
+!msvc: QMAKE_CXXFLAGS_RELEASE += -fno-math-errno
+
 DESTDIR = release
 
@@ -0,0 +1,190 @@
+// -----------------------------------------------------------------------
+// hexapodik.cpp
+// Copyright 2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+// -----------------------------------------------------------------------
+
+#include <hexapodik.h>
+#include <QtMath>
+#include <cmath>
+
+// -----------------------------------------------------------------------
+// matrice de rotation R = Rx(a).Ry(b).Rz(c) de la pose, par lignes,
+// développée à partir des 3 couples sin/cos
+
+static inline void hexapodRotation(const float* pose, float* r )
+{
+    const float a = qDegreesToRadians( pose[3] ) ;
+    const float b = qDegreesToRadians( pose[4] ) ;
+    const float c = qDegreesToRadians( pose[5] ) ;
+
+    const float ca = std::cos(a), sa = std::sin(a) ;
+    const float cb = std::cos(b), sb = std::sin(b) ;
+    const float cc = std::cos(c), sc = std::sin(c) ;
+
+    r[0] =  cb * cc ;
+    r[1] = -cb * sc ;
+    r[2] =  sb ;
+    r[3] =  ca * sc + sa * sb * cc ;
+    r[4] =  ca * cc - sa * sb * sc ;
+    r[5] = -sa * cb ;
+    r[6] =  sa * sc - ca * sb * cc ;
+    r[7] =  sa * cc + ca * sb * sc ;
+    r[8] =  ca * cb ;
+}
+
+// noyau : vecteurs vérins V = T + R.P - B pour une pose, les 8 éléments
+// (6 vérins + bourrage) étant évalués en une passe
+
+static inline void hexapodLegs(const float* pose, const float* r,
+                               const float* bx, const float* by, const float* bz,
+                               const float* px, const float* py, const float* pz,
+                               float* vx, float* vy, float* vz )
+{
+    const float tx = pose[0], ty = pose[1], tz = pose[2] ;
+
+    for ( int i = 0 ; i < HEXAPODIK_LANES ; ++i ) {
+        vx[i] = tx + r[0] * px[i] + r[1] * py[i] + r[2] * pz[i] - bx[i] ;
+        vy[i] = ty + r[3] * px[i] + r[4] * py[i] + r[5] * pz[i] - by[i] ;
+        vz[i] = tz + r[6] * px[i] + r[7] * py[i] + r[8] * pz[i] - bz[i] ;
+    }
+}
+
+// noyau : longueurs des vérins pour une pose
+
+static inline void hexapodIK(const float* pose,
+                             const float* bx, const float* by, const float* bz,
+                             const float* px, const float* py, const float* pz,
+                             float* lengths )
+{
+    float r[9] ;
+    hexapodRotation( pose, r ) ;
+
+    alignas(32) float vx[ HEXAPODIK_LANES ] ;
+    alignas(32) float vy[ HEXAPODIK_LANES ] ;
+    alignas(32) float vz[ HEXAPODIK_LANES ] ;
+    alignas(32) float len[ HEXAPODIK_LANES ] ;
+
+    hexapodLegs( pose, r, bx, by, bz, px, py, pz, vx, vy, vz ) ;
+
+    for ( int i = 0 ; i < HEXAPODIK_LANES ; ++i ) {
+        len[i] = std::sqrt( vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i] ) ;
+    }
+
+    for ( int i = 0 ; i < 6 ; ++i )    lengths[i] = len[i] ;
+}
+
+// -----------------------------------------------------------------------
+// constructeur par défaut (ancrages confondus, longueurs nulles)
+
+HexapodIK::HexapodIK()
+{
+    for ( int i = 0 ; i < HEXAPODIK_LANES ; ++i ) {
+        m_bx[i] = m_by[i] = m_bz[i] = 0 ;
+        m_px[i] = m_py[i] = m_pz[i] = 0 ;
+    }
+}
+
+// ancrages des 6 vérins : base fixe et platine au repos (repère 0XYZ)
+// les éléments de bourrage restent nuls
+
+void HexapodIK::setAnchors(const QVector3D* base, const QVector3D* top )
+{
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        m_bx[i] = base[i].x() ;
+        m_by[i] = base[i].y() ;
+        m_bz[i] = base[i].z() ;
+        m_px[i] = top[i].x() ;
+        m_py[i] = top[i].y() ;
+        m_pz[i] = top[i].z() ;
+    }
+}
+
+// -----------------------------------------------------------------------
+// calcul MGI pour une pose
+// pose = 6-DOF [ Tx,Ty,Tz, Rx,Ry,Rz ], lengths = 6 longueurs (mm)
+
+void HexapodIK::solve(const float* pose, float* lengths ) const
+{
+    hexapodIK( pose, m_bx, m_by, m_bz, m_px, m_py, m_pz, lengths ) ;
+}
+
+// calcul MGI pour un lot de 'count' poses consécutives
+// poses = count x 6 valeurs, lengths = count x 6 longueurs
+
+void HexapodIK::solve(const float* poses, float* lengths, int count ) const
+{
+    for ( int n = 0 ; n < count ; ++n ) {
+        hexapodIK( poses + 6 * n, m_bx, m_by, m_bz, m_px, m_py, m_pz, lengths + 6 * n ) ;
+    }
+}
+
+// -----------------------------------------------------------------------
+// calcul MGI pour une pose et Jacobienne dL/dQ en cette pose si 'jac'
+// (ligne i : vérin n°i, colonnes Tx,Ty,Tz en mm/mm, Rx,Ry,Rz en mm/degré)
+//
+// U = R.P, V = T + U - B, L = |V| ; dL/dT = V/L
+// la dérivée de U selon un angle est la rotation infinitésimale autour de
+// l'axe courant de cet angle : dU/dRx = X x U, dU/dRy = Rx.Y x U,
+// dU/dRz = Rx.Ry.Z x U (3e colonne de R), d'où dL/dR = axe.( U x V )/L
+
+void HexapodIK::solve(const float* pose, float* lengths, Qam6Matrix* jac ) const
+{
+    if ( !jac ) {
+        solve( pose, lengths ) ;
+        return ;
+    }
+
+    float r[9] ;
+    hexapodRotation( pose, r ) ;
+
+    alignas(32) float vx[ HEXAPODIK_LANES ] ;
+    alignas(32) float vy[ HEXAPODIK_LANES ] ;
+    alignas(32) float vz[ HEXAPODIK_LANES ] ;
+
+    hexapodLegs( pose, r, m_bx, m_by, m_bz, m_px, m_py, m_pz, vx, vy, vz ) ;
+
+    const float a = qDegreesToRadians( pose[3] ) ;
+    const float ya = std::cos(a), za = std::sin(a) ;        // axe Rx.Y = ( 0, ya, za )
+    const float k = M_PI / 180 ;                            // par degré
+
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        const float l = std::sqrt( vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i] ) ;
+        lengths[i] = l ;
+
+        // U = V - T + B, puis W = U x V
+        const float ux = vx[i] - pose[0] + m_bx[i] ;
+        const float uy = vy[i] - pose[1] + m_by[i] ;
+        const float uz = vz[i] - pose[2] + m_bz[i] ;
+        const float wx = uy * vz[i] - uz * vy[i] ;
+        const float wy = uz * vx[i] - ux * vz[i] ;
+        const float wz = ux * vy[i] - uy * vx[i] ;
+
+        const float inv = ( l > 0 ? 1 / l : 0 ) ;
+        (*jac)(i,0) = vx[i] * inv ;
+        (*jac)(i,1) = vy[i] * inv ;
+        (*jac)(i,2) = vz[i] * inv ;
+        (*jac)(i,3) = k * wx * inv ;
+        (*jac)(i,4) = k * ( ya * wy + za * wz ) * inv ;
+        (*jac)(i,5) = k * ( r[2] * wx + r[5] * wy + r[8] * wz ) * inv ;
+    }
+}
+
+// vecteurs vérins V = T + R.P - B pour une pose (6 composantes par axe)
+
+void HexapodIK::legVectors(const float* pose, float* vx, float* vy, float* vz ) const
+{
+    float r[9] ;
+    hexapodRotation( pose, r ) ;
+
+    alignas(32) float x[ HEXAPODIK_LANES ] ;
+    alignas(32) float y[ HEXAPODIK_LANES ] ;
+    alignas(32) float z[ HEXAPODIK_LANES ] ;
+
+    hexapodLegs( pose, r, m_bx, m_by, m_bz, m_px, m_py, m_pz, x, y, z ) ;
+
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        vx[i] = x[i] ;
+        vy[i] = y[i] ;
+        vz[i] = z[i] ;
+    }
+}
@@ -0,0 +1,52 @@
+// -----------------------------------------------------------------------
+// hexapodik.h
+// Copyright 2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+// -----------------------------------------------------------------------
+
+#ifndef HEXAPODIK_H
+#define HEXAPODIK_H
+
+#include <QVector3D>
+#include <qam6dof.h>
+
+// Noyau de calcul du MGI (longueurs des 6 vérins)
+// -----------------------------------------------------------------------
+// pose :    6-DOF [ Tx,Ty,Tz, Rx,Ry,Rz ] unités mm et degrés, même
+//           convention que QMatrix4x4 : translate(T) puis rotate(Rx),
+//           rotate(Ry), rotate(Rz), soit P' = T + Rx.Ry.Rz.P
+// ancrages : coordonnées rangées par composante (x[], y[], ...) sur
+//           HEXAPODIK_LANES éléments, les 6 vérins sont évalués par des
+//           boucles sans dépendance (vectorisées par le compilateur)
+// lots :    solve(poses, lengths, count) enchaîne N poses sans allocation
+//           (rejeu de vols enregistrés)
+// dérivées : solve(pose, lengths, jac) fournit aussi la Jacobienne dL/dQ
+//           (limitation de vitesse), legVectors() les vecteurs vérins
+//           (espace de travail) ; tous les calculs partagent les ancrages
+//           et la rotation du noyau
+// -----------------------------------------------------------------------
+
+#define HEXAPODIK_LANES     8       // 6 vérins + 2 éléments de bourrage
+
+class HexapodIK
+{
+  public:
+    HexapodIK() ;
+
+    void setAnchors(const QVector3D* base, const QVector3D* top ) ;
+
+    void solve(const float* pose, float* lengths ) const ;
+    void solve(const float* poses, float* lengths, int count ) const ;
+    void solve(const float* pose, float* lengths, Qam6Matrix* jac ) const ;
+    void legVectors(const float* pose, float* vx, float* vy, float* vz ) const ;
+
+  private:
+    // ancrages base fixe et platine au repos (mm)
+    alignas(32) float   m_bx[ HEXAPODIK_LANES ] ;
+    alignas(32) float   m_by[ HEXAPODIK_LANES ] ;
+    alignas(32) float   m_bz[ HEXAPODIK_LANES ] ;
+    alignas(32) float   m_px[ HEXAPODIK_LANES ] ;
+    alignas(32) float   m_py[ HEXAPODIK_LANES ] ;
+    alignas(32) float   m_pz[ HEXAPODIK_LANES ] ;
+} ;
+
+#endif // HEXAPODIK_H
@@ -18,10 +18,12 @@ HexapodMGI::HexapodMGI()
     , m_aMax( 15 )
     , m_tMax( 100 )
     , m_vSpeed( 30 )
+    , m_vAccel( 100 )
+    , m_clamped( false )
+    , m_limited( false )
 {
     m_vKin.fill( 0.0 ) ;
     m_vLen.fill( m_vMin ) ;
-    m_mKin.setToIdentity() ;
     setGeometry() ;
 }
 
@@ -36,6 +38,7 @@ void HexapodMGI::setData(const HexapodData& data )
     m_aMax = data.maxAngle ;
     m_tMax = data.maxTrans ;
     m_vSpeed = data.maxSpeed ;
+    m_vAccel = data.maxAccel ;
     setGeometry() ;
 }
 
@@ -98,50 +101,56 @@ void HexapodMGI::setGeometry()
         m_pAnc[i] = QVector3D(m_pRay * _cB(i), m_pRay * _sB(i), 0 ) ;
         m_pAncRef[i] = m_pAnc[i] ;
     }
-}
-
-// -----------------------------------------------------------------------
-// calcul MGI (longueurs respectives des 6 vérins)
-// param = 6-DOF [ Tx,Ty,Tz, Rx,Ry,Rz ] unités mm et degrés
 
-void HexapodMGI::setMGI(QamMatrix6x1 vKin )
-{
-    m_vKin = vKin ;
+    m_ik.setAnchors( m_bAnc, m_pAncRef ) ;
 
-    m_mKin.setToIdentity() ;						// calcul matrice 4x4
+    HexapodData data ;
+    data.minLen = m_vMin ;
+    data.maxLen = m_vMax ;
+    data.maxAngle = m_aMax ;
+    data.maxTrans = m_tMax ;
+    data.maxSpeed = m_vSpeed ;
+    data.maxAccel = m_vAccel ;
+    m_ws.setGeometry( &m_ik, data ) ;
 
-    m_mKin.translate( QVector3D(m_vKin(0), m_vKin(1), m_vKin(2) ) ) ;
-    m_mKin.rotate(m_vKin(3), 1, 0, 0 ) ;
-    m_mKin.rotate(m_vKin(4), 0, 1, 0 ) ;
-    m_mKin.rotate(m_vKin(5), 0, 0, 1 ) ;
-
-    for ( int i = 0 ; i < 6 ; ++i )	vlength(i) ;	// màj m_vLen
+    m_limiter.setKernel( &m_ik ) ;
+    m_limiter.setLimits( m_vSpeed, m_vAccel ) ;
 }
 
-// longueur courante du vérin d'indice i (affecte m_vLen en fonction de m_mKin)
+// -----------------------------------------------------------------------
+// calcul MGI (longueurs respectives des 6 vérins)
+// param = 6-DOF [ Tx,Ty,Tz, Rx,Ry,Rz ] unités mm et degrés
+// une pose hors de l'espace de travail est d'abord ramenée sur la pose
+// atteignable la plus proche (aucun vérin en butée)
+// dt > 0 : durée depuis l'appel précédent (s), la pose publiée ne
+// s'approche de la pose demandée qu'aux vitesse et accélération max. des
+// vérins ; dt nul : pose publiée telle quelle (initialisation)
 
-float HexapodMGI::vlength(int i )
+void HexapodMGI::setMGI(const QamMatrix6x1& vKin, float dt )
 {
-    QVector3D v = m_mKin.map( m_pAncRef[i] ) - m_bAnc[i] ;
+    float target[6] ;
+    m_clamped = !m_ws.project( vKin.constData(), target ) ;
 
-    float eps = (m_pMaxAlt - m_pMinAlt) * 0.01 ;
-//	bool err = ( v.length() > m_vMax + eps )||( v.length() < m_vMin - eps ) ;
-    m_vLen(i) = v.length() ;
+    if (( dt > 0 )&&( m_limiter.isValid() )) {
+        m_limited = !m_limiter.step( target, dt, m_vKin.data(), m_vLen.data() ) ;
+        return ;
+    }
 
-    return v.length() ;
+    for ( int i = 0 ; i < 6 ; ++i )	m_vKin(i) = target[i] ;
+    m_ik.solve( m_vKin.constData(), m_vLen.data() ) ;	// màj m_vLen
+    m_limiter.reset( target ) ;
+    m_limited = false ;
 }
 
 void HexapodMGI::resetMGI()
 {
-    QamMatrix6x1 m ;
-    m.fill( 0.0 ) ;
-    setMGI(m) ;
+    setMGI( QamMatrix6x1() ) ;
 }
 
 // -----------------------------------------------------------------------
 // sélecteur des longueurs des vérins
 
-QamMatrix6x1 HexapodMGI::actuatorLen() const
+const QamMatrix6x1& HexapodMGI::actuatorLen() const
 {
     return m_vLen ;
 }
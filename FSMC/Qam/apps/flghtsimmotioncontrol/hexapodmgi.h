@@ -3,9 +3,15 @@
 // Copyright 2021 by Alain Menu   <alain.menu@ac-creteil.fr>
 // -----------------------------------------------------------------------
 
+#ifndef HEXAPODMGI_H
+#define HEXAPODMGI_H
+
 #include <qam6dof.h>
+#include <hexapodik.h>
+#include <hexapodworkspace.h>
+#include <hexapodratelimiter.h>
 #include <QVector3D>
-#include <QMatrix4x4>
+#include <QtMath>
 
 #define	EPSILON	1e-6
 #define	COS(A)	( qAbs( qCos(A) ) < EPSILON ? 0.0 : qCos(A) )
@@ -30,6 +36,7 @@ class HexapodData
     float	maxAngle ;		// angle absolu max. pour Rx,Ry,Rz (degrés)
     float	maxTrans ;		// déplacement absolu max. pour Tx,Ty (mm)
     float	maxSpeed ;		// vitesse linéaire max. (mm/s)
+    float	maxAccel ;		// accélération linéaire max. (mm/s2)
 } ;
 
 class HexapodMGI
@@ -37,11 +44,16 @@ class HexapodMGI
   public:
     HexapodMGI() ;
     void setData(const HexapodData& data ) ;
-    void setMGI(QamMatrix6x1 vKin ) ;
+    void setMGI(const QamMatrix6x1& vKin, float dt = 0 ) ;
     void resetMGI() ;
     float minAltitude() const { return m_pMinAlt ; }
     float maxAltitude() const { return m_pMaxAlt ; }
-    QamMatrix6x1 actuatorLen() const ;
+    const QamMatrix6x1& actuatorLen() const ;
+    const HexapodIK& kernel() const { return m_ik ; }   // calculs par lots
+    const HexapodWorkspace& workspace() const { return m_ws ; }
+    bool isClamped() const { return m_clamped ; }        // dernière pose projetée
+    bool isLimited() const { return m_limited ; }        // dernière pose non atteinte
+    const HexapodRateLimiter& rateLimiter() const { return m_limiter ; }
 
   private:
 
@@ -62,6 +74,7 @@ class HexapodMGI
     float			m_aMax ;		// angle abs. max. (degrés)
     float			m_tMax ;		// Tx/Ty abs. max. (mm)
     float			m_vSpeed ;		// vitesse max. (mm/s)
+    float			m_vAccel ;		// accélération max. (mm/s2)
 
     // données calculées (système statique)
 
@@ -74,10 +87,16 @@ class HexapodMGI
 
     // données calculées (système dynamique)
 
-    QMatrix4x4		m_mKin ;		// matrice résultante 6-DOF
+    HexapodIK		m_ik ;			// noyau MGI (ancrages au repos)
+    HexapodWorkspace	m_ws ;		// poses atteignables
+    bool			m_clamped ;		// pose demandée hors de l'espace de travail
+    HexapodRateLimiter	m_limiter ;	// vitesse / accélération des vérins
+    bool			m_limited ;		// pose demandée non atteinte (limitation)
     QamMatrix6x1	m_vLen ;		// longueurs courantes des vérins
 
   private:
+    Q_DISABLE_COPY(HexapodMGI)		// m_ws et m_limiter pointent sur m_ik
     void setGeometry() ;			// calculs système statique
-    float vlength(int i ) ;			// m_mKin --> m_vLen (vérin n°i)
 } ;
+
+#endif // HEXAPODMGI_H
@@ -0,0 +1,168 @@
+// -----------------------------------------------------------------------
+// hexapodratelimiter.cpp
+// Copyright 2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+// -----------------------------------------------------------------------
+
+#include <hexapodratelimiter.h>
+#include <QtMath>
+#include <cmath>
+
+// -----------------------------------------------------------------------
+// constructeur par défaut (noyau à fournir par setKernel())
+
+HexapodRateLimiter::HexapodRateLimiter()
+    : m_ik( 0 )
+    , m_vMax( 30 )
+    , m_aMax( 100 )
+    , m_valid( false )
+{
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        m_pose[i] = m_len[i] = m_vel[i] = 0 ;
+    }
+}
+
+// noyau MGI de l'hexapode, dont les longueurs sont publiées (non possédé)
+// l'état courant est invalidé (cf. reset())
+
+void HexapodRateLimiter::setKernel(const HexapodIK* ik )
+{
+    m_ik = ik ;
+    m_valid = false ;
+}
+
+// vitesse (mm/s) et accélération (mm/s2) max. des vérins
+
+void HexapodRateLimiter::setLimits(float maxSpeed, float maxAccel )
+{
+    m_vMax = maxSpeed ;
+    m_aMax = maxAccel ;
+}
+
+// état initial : pose publiée sans limitation, vérins à l'arrêt
+
+void HexapodRateLimiter::reset(const float* pose )
+{
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        m_pose[i] = pose[i] ;
+        m_vel[i] = 0 ;
+    }
+    m_ik->solve( m_pose, m_len ) ;
+    m_valid = true ;
+}
+
+// -----------------------------------------------------------------------
+// pas de limitation
+// target :  pose demandée [ Tx,Ty,Tz, Rx,Ry,Rz ] (mm, degrés)
+// dt :      durée depuis le pas précédent (s)
+// pose :    pose publiée, lengths : longueurs correspondantes (mm)
+// retourne vrai si la pose demandée est atteinte
+
+bool HexapodRateLimiter::step(const float* target, float dt, float* pose, float* lengths )
+{
+    if ( !m_valid )     reset( target ) ;
+
+    dt = qBound( 1e-4f, dt, (float)RATELIMIT_MAX_DT ) ;
+
+    // pose demandée, angles par le plus court chemin depuis la pose courante
+    float goal[6] ;
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        goal[i] = target[i] ;
+        if ( i >= 3 )   goal[i] = m_pose[i] + std::remainder( target[i] - m_pose[i], 360.0f ) ;
+    }
+    float goalLen[6] ;
+    m_ik->solve( goal, goalLen ) ;
+
+    // profil de chaque vérin : déplacement dL du pas
+    Qam6Vector dl ;
+    bool reached = true ;
+    const float h = 0.5f * m_aMax * dt ;
+
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        const float e = goalLen[i] - m_len[i] ;                 // distance restante
+
+        // vitesse visée : vMax, réduite à la vitesse d'arrêt sur |e| (freinage
+        // à aMax par pas de dt), puis bornée à aMax.dt de la vitesse courante
+        float vGoal = qMin( m_vMax, std::sqrt( 2 * m_aMax * qAbs( e ) + h * h ) - h ) ;
+        vGoal = ( e < 0 ? -vGoal : vGoal ) ;
+        const float v = qBound( m_vel[i] - m_aMax * dt, vGoal, m_vel[i] + m_aMax * dt ) ;
+
+        dl(i) = v * dt ;
+        if ((( e >= 0 )&&( dl(i) >= e ))||(( e <= 0 )&&( dl(i) <= e )))    dl(i) = e ;     // consigne atteinte
+        else    reached = false ;
+    }
+
+    float len[6] ;
+    for ( int i = 0 ; i < 6 ; ++i )     len[i] = m_len[i] ;
+
+    if ( reached ) {
+        for ( int i = 0 ; i < 6 ; ++i )     m_pose[i] = goal[i] ;
+    }
+    else {
+        // dQ = J-1.dL en la pose courante, moindres carrés amortis si J est
+        // singulière (N = Jt.J + d2.I toujours inversible)
+        Qam6Matrix  jac ;
+        int         perm[6] ;
+        m_ik->solve( m_pose, len, &jac ) ;
+
+        Qam6Matrix  lu = jac ;
+        bool        damped = !lu.decompose( perm ) ;
+
+        if ( damped ) {
+            const float d2 = RATELIMIT_DAMPING * RATELIMIT_DAMPING ;
+            for ( int r = 0 ; r < 6 ; ++r ) {
+                for ( int c = 0 ; c < 6 ; ++c ) {
+                    float n = ( r == c ? d2 : 0 ) ;
+                    for ( int k = 0 ; k < 6 ; ++k )     n += jac(k,r) * jac(k,c) ;
+                    lu(r,c) = n ;
+                }
+            }
+        }
+
+        if (( !damped )||( lu.decompose( perm ) )) {
+            Qam6Vector dq = dl ;
+            delta( jac, lu, perm, damped, dq ) ;
+
+            float next[6] ;
+            for ( int i = 0 ; i < 6 ; ++i )     next[i] = m_pose[i] + dq(i) ;
+
+            // correction de Newton : écart aux longueurs visées L + dL
+            float nextLen[6] ;
+            m_ik->solve( next, nextLen ) ;
+            for ( int i = 0 ; i < 6 ; ++i )     dq(i) = len[i] + dl(i) - nextLen[i] ;
+            delta( jac, lu, perm, damped, dq ) ;
+
+            for ( int i = 0 ; i < 6 ; ++i )     m_pose[i] = next[i] + dq(i) ;
+        }
+        else {
+            // géométrie incohérente (valeurs non finies) : pose demandée
+            // publiée telle quelle, comme à l'initialisation
+            reset( goal ) ;
+            for ( int i = 0 ; i < 6 ; ++i )     len[i] = m_len[i] ;
+        }
+    }
+
+    // pose publiée et vitesses réelles des vérins
+    for ( int i = 3 ; i < 6 ; ++i )     m_pose[i] = std::remainder( m_pose[i], 360.0f ) ;
+    m_ik->solve( m_pose, m_len ) ;
+
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        m_vel[i] = ( m_len[i] - len[i] ) / dt ;
+        pose[i] = m_pose[i] ;
+        lengths[i] = m_len[i] ;
+    }
+
+    return reached ;
+}
+
+// -----------------------------------------------------------------------
+// [private] résolution de J.dQ = dL (dq <-- dQ) à partir des facteurs LU de
+// J, ou de N = Jt.J + d2.I si 'damped' (second membre Jt.dL)
+
+void HexapodRateLimiter::delta(const Qam6Matrix& jac, const Qam6Matrix& lu, const int* perm, bool damped, Qam6Vector& dq )
+{
+    if ( damped ) {
+        Qam6Vector dl = dq ;
+        jac.multTransposed( dl, dq ) ;
+    }
+    lu.substitute( perm, dq ) ;
+}
@@ -0,0 +1,61 @@
+// -----------------------------------------------------------------------
+// hexapodratelimiter.h
+// Copyright 2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+// -----------------------------------------------------------------------
+
+#ifndef HEXAPODRATELIMITER_H
+#define HEXAPODRATELIMITER_H
+
+#include <hexapodik.h>
+
+// Limitation de vitesse et d'accélération des vérins
+// -----------------------------------------------------------------------
+// chaque vérin suit son propre profil vers sa longueur finale (MGI de la
+// pose demandée) : la vitesse visée est la vitesse max., réduite à la
+// vitesse d'arrêt sur la distance restante pour freiner à amax avant la
+// consigne, et la vitesse du pas s'en approche à amax.dt près de celle du
+// pas précédent ; un vérin qui doit s'inverser décélère donc à amax sans
+// bloquer les autres
+// le déplacement dL des vérins est ramené en pose par la Jacobienne
+// analytique J = dL/dQ du noyau HexapodIK en la pose courante (dQ = J-1.dL,
+// LU), suivi d'une correction de Newton à Jacobienne conservée ; près d'une
+// configuration singulière, dQ est la solution des moindres carrés amortis
+// ( Jt.J + d2.I ).dQ = Jt.dL, la pose continuant d'évoluer vers la consigne
+// les longueurs publiées sont celles de la pose obtenue (MGI exact)
+// coût constant par pas : 4 évaluations des 6 vérins, une décomposition LU
+// -----------------------------------------------------------------------
+
+#define RATELIMIT_MAX_DT    0.1     // pas max. pris en compte (s), après une pause
+#define RATELIMIT_DAMPING   0.1     // amortissement d des moindres carrés (mm/mm)
+
+class HexapodRateLimiter
+{
+  public:
+    HexapodRateLimiter() ;
+
+    void setKernel(const HexapodIK* ik ) ;
+    void setLimits(float maxSpeed, float maxAccel ) ;
+    void reset(const float* pose ) ;
+    bool isValid() const { return m_valid && m_ik ; }
+
+    bool step(const float* target, float dt, float* pose, float* lengths ) ;
+
+    const float* velocity() const { return m_vel ; }        // vitesses des vérins (mm/s)
+
+  private:
+    static void delta(const Qam6Matrix& jac, const Qam6Matrix& lu, const int* perm, bool damped, Qam6Vector& dq ) ;
+
+  private:
+    const HexapodIK*    m_ik ;  // noyau MGI (ancrages de l'hexapode)
+
+    float   m_vMax ;            // vitesse max. des vérins (mm/s)
+    float   m_aMax ;            // accélération max. des vérins (mm/s2)
+
+    // état publié
+    bool    m_valid ;
+    float   m_pose[6] ;         // pose (mm, degrés)
+    float   m_len[6] ;          // longueurs (mm)
+    float   m_vel[6] ;          // vitesses (mm/s)
+} ;
+
+#endif // HEXAPODRATELIMITER_H
@@ -0,0 +1,169 @@
+// -----------------------------------------------------------------------
+// hexapodworkspace.cpp
+// Copyright 2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+// -----------------------------------------------------------------------
+
+#include <hexapodworkspace.h>
+#include <hexapodmgi.h>
+#include <QtMath>
+#include <cmath>
+
+// -----------------------------------------------------------------------
+// constructeur par défaut (géométrie à fournir par setGeometry())
+
+HexapodWorkspace::HexapodWorkspace()
+    : m_ik( 0 )
+    , m_minLen( 0 )
+    , m_maxLen( 0 )
+    , m_margin( 0 )
+    , m_min2( 0 )
+    , m_max2( 0 )
+    , m_maxTrans( 0 )
+    , m_maxAngle( 0 )
+    , m_zNeutral( 0 )
+{
+}
+
+// noyau MGI de l'hexapode (ancrages, non possédé) et limites mécaniques
+// la marge aux butées est ramenée à WORKSPACE_MARGIN de la course
+
+void HexapodWorkspace::setGeometry(const HexapodIK* ik, const HexapodData& data )
+{
+    m_ik = ik ;
+    m_minLen = data.minLen ;
+    m_maxLen = data.maxLen ;
+    m_maxTrans = data.maxTrans ;
+    m_maxAngle = data.maxAngle ;
+    m_margin = WORKSPACE_MARGIN * ( m_maxLen - m_minLen ) ;
+
+    updateLimits() ;
+}
+
+// marge aux butées des vérins (mm)
+
+void HexapodWorkspace::setMargin(float mm )
+{
+    m_margin = qBound( 0.0f, mm, 0.5f * ( m_maxLen - m_minLen ) ) ;
+    updateLimits() ;
+}
+
+// [private] carrés des longueurs admissibles et altitude neutre
+
+void HexapodWorkspace::updateLimits()
+{
+    float lmin = m_minLen + m_margin ;
+    float lmax = m_maxLen - m_margin ;
+    m_min2 = lmin * lmin ;
+    m_max2 = lmax * lmax ;
+
+    const float zero[6] = { 0, 0, 0, 0, 0, 0 } ;
+    float lo, hi ;
+    m_zNeutral = ( heaveRange( zero, lo, hi ) ? 0.5f * ( lo + hi ) : 0 ) ;
+}
+
+// -----------------------------------------------------------------------
+// intervalle [lo,hi] des Tz admissibles pour Tx,Ty,Rx,Ry,Rz de 'pose'
+// (Tz de 'pose' ignoré) ; retourne faux si l'intervalle est vide
+//
+// vérin n°i : V = (0,0,Tz) + W, W = (Tx,Ty,0) + R.P(i) - B(i)
+// |V|^2 = h2 + (Tz + Wz)^2 avec h2 = Wx^2 + Wy^2, croissant en Tz tant
+// que la platine reste au-dessus de l'ancrage de base (Tz + Wz > 0)
+
+bool HexapodWorkspace::heaveRange(const float* pose, float& lo, float& hi ) const
+{
+    if ( !m_ik )    return false ;
+
+    // W : vecteurs vérins à Tz nul
+    float q[6] = { pose[0], pose[1], 0, pose[3], pose[4], pose[5] } ;
+    float wx[6], wy[6], wz[6] ;
+    m_ik->legVectors( q, wx, wy, wz ) ;
+
+    lo = -HUGE_VALF ;
+    hi =  HUGE_VALF ;
+
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        const float h2 = wx[i] * wx[i] + wy[i] * wy[i] ;
+
+        if ( h2 > m_max2 )  return false ;      // vérin trop long quel que soit Tz
+
+        float zlo = ( h2 < m_min2 ? std::sqrt( m_min2 - h2 ) : 0.0f ) - wz[i] ;
+        float zhi = std::sqrt( m_max2 - h2 ) - wz[i] ;
+        if ( zlo > lo )     lo = zlo ;
+        if ( zhi < hi )     hi = zhi ;
+    }
+    return lo <= hi ;
+}
+
+// vrai si la pose respecte les limites articulaires et laisse chaque
+// vérin à distance de ses butées (angles ramenés dans ]-180,180] comme
+// par project())
+
+bool HexapodWorkspace::isFeasible(const float* pose ) const
+{
+    float q[6] ;
+    foldAngles( pose, q ) ;
+
+    if (( qAbs( q[0] ) > m_maxTrans )||( qAbs( q[1] ) > m_maxTrans ))  return false ;
+    for ( int i = 3 ; i < 6 ; ++i ) {
+        if ( qAbs( q[i] ) > m_maxAngle )    return false ;
+    }
+
+    float lo, hi ;
+    return heaveRange( q, lo, hi ) && ( q[2] >= lo ) && ( q[2] <= hi ) ;
+}
+
+// -----------------------------------------------------------------------
+// projection de 'pose' sur l'espace de travail (résultat dans 'out')
+// retourne vrai si la pose était atteignable telle quelle (à un tour près)
+
+bool HexapodWorkspace::project(const float* pose, float* out ) const
+{
+    float q[6] ;
+    foldAngles( pose, q ) ;
+
+    // limites articulaires
+    out[0] = qBound( -m_maxTrans, q[0], m_maxTrans ) ;
+    out[1] = qBound( -m_maxTrans, q[1], m_maxTrans ) ;
+    out[2] = q[2] ;
+    for ( int i = 3 ; i < 6 ; ++i ) {
+        out[i] = qBound( -m_maxAngle, q[i], m_maxAngle ) ;
+    }
+
+    float lo, hi ;
+
+    // orientation sans Tz admissible : réduction vers la pose neutre
+    // (facteur d'échelle s sur Tx,Ty,Rx,Ry,Rz, s = 0 toujours atteignable)
+    if ( !heaveRange( out, lo, hi ) ) {
+        float req[6] ;
+        for ( int i = 0 ; i < 6 ; ++i )     req[i] = out[i] ;
+
+        float sLo = 0, sHi = 1 ;
+        for ( int k = 0 ; k < WORKSPACE_BISECTIONS ; ++k ) {
+            float s = 0.5f * ( sLo + sHi ) ;
+            for ( int i = 0 ; i < 6 ; ++i )     out[i] = ( i == 2 ? req[i] : s * req[i] ) ;
+            if ( heaveRange( out, lo, hi ) )    sLo = s ;
+            else                                sHi = s ;
+        }
+        for ( int i = 0 ; i < 6 ; ++i )     out[i] = ( i == 2 ? req[i] : sLo * req[i] ) ;
+        if ( !heaveRange( out, lo, hi ) ) {             // géométrie incohérente
+            lo = hi = m_zNeutral ;
+        }
+    }
+
+    // altitude
+    out[2] = qBound( lo, out[2], hi ) ;
+
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        if ( out[i] != q[i] )   return false ;
+    }
+    return true ;
+}
+
+// [private] copie de 'pose', angles ramenés dans ]-180,180]
+
+void HexapodWorkspace::foldAngles(const float* pose, float* out )
+{
+    for ( int i = 0 ; i < 6 ; ++i ) {
+        out[i] = ( i < 3 ? pose[i] : std::remainder( pose[i], 360.0f ) ) ;
+    }
+}
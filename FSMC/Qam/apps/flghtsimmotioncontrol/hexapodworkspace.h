@@ -0,0 +1,65 @@
+// -----------------------------------------------------------------------
+// hexapodworkspace.h
+// Copyright 2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+// -----------------------------------------------------------------------
+
+#ifndef HEXAPODWORKSPACE_H
+#define HEXAPODWORKSPACE_H
+
+#include <hexapodik.h>
+
+class HexapodData ;
+
+// Espace de travail de l'hexapode (poses atteignables)
+// -----------------------------------------------------------------------
+// pose :     6-DOF [ Tx,Ty,Tz, Rx,Ry,Rz ] unités mm et degrés, convention
+//            de HexapodIK (P' = T + Rx.Ry.Rz.P)
+// limites :  |Tx|,|Ty| <= maxTrans, |Rx|,|Ry|,|Rz| <= maxAngle, et chaque
+//            vérin dans [ minLen + marge, maxLen - marge ]
+// altitude : pour Tx,Ty et une orientation donnés, la longueur de chaque
+//            vérin est monotone en Tz ; l'intervalle de Tz admissible est
+//            donc l'intersection de 6 intervalles calculés directement
+//            (heaveRange) à partir des vecteurs vérins du noyau HexapodIK,
+//            sans recherche ni table
+// projection : bornage de chaque DOF (angles ramenés à +-180 degrés, cap
+//            X-Plane 0..360 par exemple), puis de Tz dans son intervalle ; si
+//            l'orientation n'en admet aucun, la pose est ramenée vers la
+//            position neutre par dichotomie sur un facteur d'échelle
+// -----------------------------------------------------------------------
+
+#define WORKSPACE_MARGIN        0.02    // marge aux butées (fraction de la course)
+#define WORKSPACE_BISECTIONS    12      // itérations de la projection par échelle
+
+class HexapodWorkspace
+{
+  public:
+    HexapodWorkspace() ;
+
+    void setGeometry(const HexapodIK* ik, const HexapodData& data ) ;
+    void setMargin(float mm ) ;
+    float margin() const { return m_margin ; }
+    float neutralHeave() const { return m_zNeutral ; }
+
+    bool isFeasible(const float* pose ) const ;
+    bool heaveRange(const float* pose, float& lo, float& hi ) const ;
+    bool project(const float* pose, float* out ) const ;
+
+  private:
+    void updateLimits() ;
+    static void foldAngles(const float* pose, float* out ) ;
+
+  private:
+    const HexapodIK*    m_ik ;  // noyau MGI (ancrages de l'hexapode)
+
+    // limites
+    float   m_minLen ;          // course des vérins (mm)
+    float   m_maxLen ;
+    float   m_margin ;          // marge aux butées (mm)
+    float   m_min2 ;            // ( minLen + marge )^2
+    float   m_max2 ;            // ( maxLen - marge )^2
+    float   m_maxTrans ;        // |Tx|, |Ty| max. (mm)
+    float   m_maxAngle ;        // |Rx|, |Ry|, |Rz| max. (degrés)
+    float   m_zNeutral ;        // Tz au milieu de l'intervalle, orientation nulle
+} ;
+
+#endif // HEXAPODWORKSPACE_H
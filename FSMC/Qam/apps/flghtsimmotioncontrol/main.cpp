@@ -10,17 +10,19 @@ int main(int argc, char *argv[] )
 {
     QApplication app(argc, argv ) ;
 
-    UDP w;
-    w.show();
     //if ( args.size() < 2 ) {
     //    cerr << "usage: " << qPrintable( args.at(0) ) << " <configFile>" << endl ;
     //    return -1 ;
     //}
     ModipSlave* slave = new ModipSlave( ":/fsmockup.csv",  &app ) ;
-    w.slave = slave;
+
+    QStringList args = QApplication::arguments() ;
+    QString host = args.size() > 1 ? args.at(1) : QString( XPLANE_HOST ) ;	// hôte X-Plane optionnel
+
+    UDP w( slave, host ) ;	// démarre le thread de réception X-Plane
+    w.show();
 
     QObject::connect(slave, SIGNAL(quit()), &app, SLOT(quit()) ) ;
-    QObject::connect(w.slave, SIGNAL(quit()), &app, SLOT(quit()) ) ;
     return app.exec() ;
 }
 
@@ -7,6 +7,10 @@ using namespace std ;
 ModipSlave::ModipSlave(const QString& configFile, QObject* parent )
     : QObject(parent)
 {
+    // journal différé des messages par requête (niveau Debug pour les voir)
+
+    QamTrace::start( QamTrace::Info ) ;
+
     // cartographie Modbus
 
     m_map    = new QamModbusMap( QamModbusMap::ServerMode, this ) ;
@@ -18,11 +22,26 @@ ModipSlave::ModipSlave(const QString& configFile, QObject* parent )
 
     m_map->loadMap( configFile ) ;
 
+    // références directes sur les registres écrits à chaque pose
+
+    m_pose[0] = m_map->handle( QamModbusMap::HoldingRegister, "Rx" ) ;
+    m_pose[1] = m_map->handle( QamModbusMap::HoldingRegister, "Ry" ) ;
+    m_pose[2] = m_map->handle( QamModbusMap::HoldingRegister, "Rz" ) ;
+
     // serveur TCP
 
     m_server = new QamTcpServer( m_map, this ) ;
+    m_server->setMode( QamTcpServer::Reactor, 1 ) ;	// clients servis hors du thread IHM
+    m_server->setMaxConnections( 64 ) ;
     m_hexapodmgi = new HexapodMGI();
     m_server->start( m_map->port() ) ;
+
+    // canal de notification des changements (clients de visualisation)
+
+    m_push = new QamModbusPushServer( m_map, this ) ;
+    m_pushServer = new QamTcpServer( m_push, this ) ;
+    m_pushServer->setMode( QamTcpServer::Reactor, 1 ) ;
+    m_pushServer->start( m_map->port() + MODBUSPUSH_PORT_OFFSET ) ;
    // m_map->setValue( QamModbusMap::HoldingRegister, "Ry","3.14") ;
     //qDebug() << MGI(20,20,20);
     //QamMatrix6x1 test;// = m_hexapodmgi->actuatorLen() ;
@@ -54,7 +73,16 @@ void ModipSlave::SetValue(QString val,QString name)
      m_map->setValue(table, name,val) ;
 
 }
-QamMatrix6x1 ModipSlave::MGI(float Rx, float Ry, float Rz)
+// écriture des trois angles (degrés) sous un seul verrouillage de la
+// cartographie ; le tangage est inversé (convention de la plateforme)
+
+void ModipSlave::setPose(float Rx, float Ry, float Rz )
+{
+    float values[3] = { Rx * 100, Ry * -100, Rz * 100 } ;
+
+    m_map->setLocalValues( m_pose, values, 3 ) ;
+}
+const QamMatrix6x1& ModipSlave::MGI(float Rx, float Ry, float Rz)
 {
     // param = 6-DOF [ Tx,Ty,Tz, Rx,Ry,Rz ] unités mm et degrés
 
@@ -76,7 +104,12 @@ QamMatrix6x1 ModipSlave::MGI(float Rx, float Ry, float Rz)
     kin(4) = Ry;
     kin(5) = Rz;
 
-    m_hexapodmgi->setMGI(kin);
+    // durée depuis la pose précédente : vitesse et accélération des vérins
+    // limitées (nulle à la première pose)
+    float dt = ( m_mgiClock.isValid() ? m_mgiClock.nsecsElapsed() * 1e-9 : 0 ) ;
+    m_mgiClock.start() ;
+
+    m_hexapodmgi->setMGI(kin, dt);
     //qDebug() << kin;
     return m_hexapodmgi->actuatorLen() ;
 }
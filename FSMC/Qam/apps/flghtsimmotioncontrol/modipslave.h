@@ -4,7 +4,10 @@
 #include <QObject>
 #include <qammodbusmap.h>
 #include <qamtcpserver.h>
+#include <qamtrace.h>
+#include <qammodbuspush.h>
 #include <hexapodmgi.h>
+#include <QElapsedTimer>
 class ModipSlave : public QObject
 {
     Q_OBJECT
@@ -13,7 +16,8 @@ class ModipSlave : public QObject
 
     explicit ModipSlave(const QString& configFile, QObject* parent = 0 ) ;
      void SetValue(QString ,QString);
-         QamMatrix6x1 MGI(float Rx, float Ry, float Rz);
+         const QamMatrix6x1& MGI(float Rx, float Ry, float Rz);
+    void setPose(float Rx, float Ry, float Rz ) ;	// registres Rx, Ry, Rz (1/100 degré)
 QamModbusMap*	m_map ;
   signals:
     void quit() ;	// signal à émettre pour terminer l'application...
@@ -25,7 +29,11 @@ QamModbusMap*	m_map ;
   private:
 
     QamTcpServer*	m_server ;
+    QamModbusPushServer*	m_push ;		// canal de notification des changements
+    QamTcpServer*	m_pushServer ;
     HexapodMGI*     m_hexapodmgi;
+    QElapsedTimer   m_mgiClock ;	// durée entre deux poses (limitation de vitesse)
+    QamModbusMap::Handle    m_pose[3] ;	// Rx, Ry, Rz résolus au démarrage
 } ;
 
 #endif // MODIPSLAVE_H
@@ -1,110 +1,51 @@
 #include <QDebug>
-#include <qiodevice.h>
 #include <QTimer>
 #include "trdatagram.h"
 #include "ui_trdatagram.h"
 #include "modipslave.h"
 
-UDP::UDP(QWidget *parent)
+UDP::UDP(ModipSlave* slave, const QString& host, QWidget *parent)
     : QWidget(parent)
+    , slave(slave)
     , ui(new Ui::UDP)
 {
 
     ui->setupUi(this);
-    socket = new QUdpSocket(this);
-    socket->bind(QHostAddress("192.168.0.103"), 49000);
 
-    envoieDatagram();
-    timer = new QTimer();
-    timer->start(100);
+    receiver = new XPlaneReceiver(slave, host, XPLANE_PORT, this);//reception et MGI hors du thread graphique
+    receiver->start(QThread::TimeCriticalPriority);
 
-    QTimer::connect(timer , SIGNAL(timeout()),this,SLOT(disconnected()));
-
-    connect(socket, SIGNAL(readyRead()), this, SLOT(traitementDatagram()),Qt::QueuedConnection);
+    timer = new QTimer(this);
+    QTimer::connect(timer , SIGNAL(timeout()),this,SLOT(refreshDisplay()));
+    timer->start(40);//affichage a 25Hz, independant de la reception
 
 }
 
 UDP::~UDP()
 {
+    delete receiver;//arret du thread de reception
     delete ui;
 }
-void UDP::disconnected()
-{
-    ui->statconnection->setText("<font color='red'>DECONNECTER</font>");
-}
-void UDP::envoieDatagram()
+void UDP::refreshDisplay()
 {
-    QByteArray RPOS = "RPOS050" ; //datagrams pour position , envoye a 50Hz
-
-    socket->writeDatagram(RPOS.data(),RPOS.size(),QHostAddress("192.168.0.103"),49000);//envoie demande de datagramme RPOS a Xplane
-
+    XPlaneSnapshot s;
+
+    if(receiver->latest(s) == false) return;//pas de nouvel etat depuis le dernier affichage
+
+    if(s.rposFresh)ui->statconnection->setText("<font color='lime'>CONNECTER</font>");//fraicheur du flux RPOS
+    else ui->statconnection->setText("<font color='red'>DECONNECTER</font>");
+    ui->statconnection->setToolTip(QString("RREF %1 - recus %2 / rejetes %3 / perimes %4 / lots %5 / souscriptions %6")
+                                   .arg(s.rrefFresh ? "actif" : "perdu")
+                                   .arg(s.received).arg(s.dropped).arg(s.superseded).arg(s.batches).arg(s.subscriptions));
+
+    ui->labpitch->setText(QString::number(s.pitch));//affichage du tangage sur l'application
+    ui->labheading->setText(QString::number(s.heading));//affichage du lacet sur l'application
+    ui->labroll->setText(QString::number(s.roll));//affichage du roulis sur l'application
+
+    ui->LL1->setText(QString::number(s.len[0]));//affichage de la longeur des verins
+    ui->LL2->setText(QString::number(s.len[1]));
+    ui->LL3->setText(QString::number(s.len[2]));
+    ui->LL4->setText(QString::number(s.len[3]));
+    ui->LL5->setText(QString::number(s.len[4]));
+    ui->LL6->setText(QString::number(s.len[5]));
 }
-void UDP::traitementDatagram()
-{
-
-    timer->start(100);
-    ui->statconnection->setText("<font color='lime'>CONNECTER</font>");
-    bool isdebug = false ; // variable activation debug
-
-    QHostAddress sender;
-    u_int16_t port;
-    QByteArray datagram ;
-
-    datagram.resize(socket->pendingDatagramSize());
-    socket->readDatagram(datagram.data(),datagram.size(),&sender,&port);//lecture datagramme recu
-
-    if(isdebug == true )qDebug() << datagram;
-
-    float* p = (float*)(&datagram[33]) ;//exctraction des donnée sur le datagrams de reponse
-    QString ps = QString::number(*p);
-
-    float* h = (float*)(&datagram[37]) ;
-    QString hs = QString::number(*h);
-
-    float* r = (float*)(&datagram[41]) ;
-    QString rs = QString::number(*r);
-
-    if((ps.contains("3140.2") && hs.contains("820340") && rs.contains("2.14218e+08") )== false ){//suppression de donnée phantome
-
-        //qDebug() << ps.toFloat();
-
-
-
-        ui->labpitch->setText(ps);//affichage du tangage sur l'application
-        slave->SetValue( QString::number(round(ps.toFloat()*100)*-1) ,QString("Ry"));
-
-        ui->labheading->setText(hs);//affichage du lacet sur l'application
-        slave->SetValue( QString::number(round(hs.toFloat()*100)) ,QString("Rz"));
-
-        ui->labroll->setText(rs);//affichage du roulis sur l'application
-        slave->SetValue( QString::number(round(rs.toFloat()*100)) ,QString("Rx"));
-
-        qDebug() << "=========================================";
-        QamMatrix6x1 LengthVerin = slave->MGI(rs.toFloat(),ps.toFloat(),hs.toFloat());//recuperation longeur verins via le MGI
-
-
-
-        /*slave->SetValue(QString::number(round(LengthVerin(0))),QString("L1"));
-        slave->SetValue(QString::number(round(LengthVerin(1))),QString("L2"));
-        slave->SetValue(QString::number(round(LengthVerin(2))),QString("L3"));
-        slave->SetValue(QString::number(round(LengthVerin(3))),QString("L4"));
-        slave->SetValue(QString::number(round(LengthVerin(4))),QString("L5"));
-        slave->SetValue(QString::number(round(LengthVerin(5))),QString("L6"));*/
-
-
-        ui->LL1->setText(QString::number(LengthVerin(0)));//affichage de la longeur des verins
-        ui->LL2->setText(QString::number(LengthVerin(1)));
-        ui->LL3->setText(QString::number(LengthVerin(2)));
-        ui->LL4->setText(QString::number(LengthVerin(3)));
-        ui->LL5->setText(QString::number(LengthVerin(4)));
-        ui->LL6->setText(QString::number(LengthVerin(5)));
-
-    }
-
-
-}
-
-
-
-
-
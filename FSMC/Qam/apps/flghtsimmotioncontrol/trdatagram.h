@@ -2,8 +2,9 @@
 #define TRDATAGRAM_H
 
 #include <QWidget>
-#include <QUdpSocket>
+#include <QTimer>
 #include "modipslave.h"
+#include "xplanereceiver.h"
 QT_BEGIN_NAMESPACE
 namespace Ui { class UDP; }
 QT_END_NAMESPACE
@@ -13,25 +14,19 @@ class UDP : public QWidget
     Q_OBJECT
 
 public:
-    explicit UDP(QWidget *parent = nullptr);
+    explicit UDP(ModipSlave* slave, const QString& host = XPLANE_HOST, QWidget *parent = nullptr);
     ~UDP();
     ModipSlave* slave;
 
 private slots:
-    void traitementDatagram();
-    void envoieDatagram();
-    void disconnected();
+    void refreshDisplay();
 
 signals:
 
 private:
     Ui::UDP *ui;
-     QUdpSocket *socket = nullptr;
-     QTimer *timer;
+     XPlaneReceiver *receiver;      // reception X-Plane et MGI (thread dedie)
+     QTimer *timer;                 // cadence d'affichage
      void change(float);
 };
 #endif // TRDATAGRAM_H
-
-
-
-
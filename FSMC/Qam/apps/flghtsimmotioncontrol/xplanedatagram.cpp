@@ -0,0 +1,79 @@
+// -----------------------------------------------------------------------
+// xplanedatagram.cpp
+// Décodage des datagrammes UDP émis par X-Plane (RPOS, RREF)
+// -----------------------------------------------------------------------
+
+#include "xplanedatagram.h"
+#include <QtNumeric>
+#include <cstring>
+
+// -----------------------------------------------------------------------
+// identification d'un datagramme par son entête (4 caractères)
+
+XPlaneDatagram::Type XPlaneDatagram::type(const char* data, qint64 size )
+{
+    if (( data == nullptr )||( size < XPLANE_HEADER_SIZE ))	return Invalid ;
+
+    if ( std::memcmp( data, "RPOS", 4 ) == 0 )	return Rpos ;
+    if ( std::memcmp( data, "RREF", 4 ) == 0 )	return Rref ;
+
+    return Invalid ;
+}
+
+// -----------------------------------------------------------------------
+// vue RPOS : contrôle de l'entête, de la longueur et de la cohérence
+// des angles (élimine les datagrammes "fantômes" reçus hors session)
+
+const XPlaneRpos* XPlaneDatagram::rpos(const char* data, qint64 size )
+{
+    if ( type( data, size ) != Rpos )	return nullptr ;
+    if ( size < (qint64)sizeof(XPlaneRpos) )	return nullptr ;
+
+    const XPlaneRpos* p = reinterpret_cast<const XPlaneRpos*>( data ) ;
+
+    return isAttitudeValid( p ) ? p : nullptr ;
+}
+
+// -----------------------------------------------------------------------
+// vue RREF : la charge utile doit être un multiple de 8 octets
+
+const XPlaneRrefValue* XPlaneDatagram::rref(const char* data, qint64 size, int& count )
+{
+    count = 0 ;
+    if ( type( data, size ) != Rref )	return nullptr ;
+
+    qint64 payload = size - XPLANE_HEADER_SIZE ;
+    if (( payload <= 0 )||( payload % sizeof(XPlaneRrefValue) ))	return nullptr ;
+
+    count = int( payload / sizeof(XPlaneRrefValue) ) ;
+    return reinterpret_cast<const XPlaneRrefValue*>( data + XPLANE_HEADER_SIZE ) ;
+}
+
+// -----------------------------------------------------------------------
+// requête RREF (chemin tronqué si nécessaire, toujours terminé par '\0')
+
+void XPlaneDatagram::rrefRequest(XPlaneRrefRequest& req, int freq, int index, const char* path )
+{
+    std::memset( &req, 0, sizeof(req) ) ;
+    std::memcpy( req.header, "RREF", 4 ) ;
+    req.freq = freq ;
+    req.index = index ;
+    std::strncpy( req.path, path, XPLANE_RREF_PATH - 1 ) ;
+}
+
+// [private] angles finis et dans leurs intervalles de définition
+
+bool XPlaneDatagram::isAttitudeValid(const XPlaneRpos* rpos )
+{
+    float pitch = rpos->pitch ;
+    float heading = rpos->heading ;
+    float roll = rpos->roll ;
+
+    if ( !qIsFinite( pitch ) || !qIsFinite( heading ) || !qIsFinite( roll ) )	return false ;
+
+    if ( qAbs( pitch ) > 90.0f )	return false ;
+    if ( qAbs( roll ) > 180.0f )	return false ;
+    if (( heading < -360.0f )||( heading > 360.0f ))	return false ;
+
+    return true ;
+}
@@ -0,0 +1,88 @@
+// -----------------------------------------------------------------------
+// xplanedatagram.h
+// Décodage des datagrammes UDP émis par X-Plane (RPOS, RREF)
+// -----------------------------------------------------------------------
+
+#ifndef XPLANEDATAGRAM_H
+#define XPLANEDATAGRAM_H
+
+#include <QtGlobal>
+
+#define	XPLANE_HEADER_SIZE		5		// "RPOS" / "RREF" + octet de séparation
+#define	XPLANE_MAX_DATAGRAM		2048	// taille du tampon de réception
+#define	XPLANE_RREF_PATH		400		// taille du chemin d'une requête RREF
+
+// Datagramme RPOS (réponse à une requête "RPOSxxx", xxx = fréquence en Hz)
+// -----------------------------------------------------------------------
+// structure "packed" : vue directe sur le tampon de réception, les champs
+// sont lus en place sans copie ni conversion intermédiaire
+//
+//  offset |  0    5       13      21      29   33     37   41   45 .. 65
+//  champ  | hdr  lon     lat     ele     agl  pitch  hdg  roll vx .. r
+
+#pragma pack(push, 1)
+
+struct XPlaneRpos
+{
+    char    header[XPLANE_HEADER_SIZE] ;
+    double  longitude ;		// degrés
+    double  latitude ;		// degrés
+    double  elevation ;		// altitude MSL (m)
+    float   agl ;			// hauteur sol (m)
+    float   pitch ;			// tangage (degrés)
+    float   heading ;		// cap vrai (degrés)
+    float   roll ;			// roulis (degrés)
+    float   vx ;			// vitesses repère OpenGL (m/s)
+    float   vy ;
+    float   vz ;
+    float   p ;				// vitesses angulaires roulis, tangage, lacet (rad/s)
+    float   q ;
+    float   r ;
+} ;
+
+// Valeur élémentaire d'un datagramme RREF : couple (indice, valeur),
+// l'indice est celui fourni par le client lors de la souscription
+
+struct XPlaneRrefValue
+{
+    qint32  index ;
+    float   value ;
+} ;
+
+// Requête de souscription RREF : X-Plane émet ensuite la dataref 'path'
+// à 'freq' Hz sous l'indice 'index' (freq = 0 pour arrêter l'émission)
+
+struct XPlaneRrefRequest
+{
+    char    header[XPLANE_HEADER_SIZE] ;	// "RREF\0"
+    qint32  freq ;
+    qint32  index ;
+    char    path[XPLANE_RREF_PATH] ;
+} ;
+
+#pragma pack(pop)
+
+// Décodeur (sans allocation, sans conversion en chaîne de caractères)
+// -----------------------------------------------------------------------
+
+class XPlaneDatagram
+{
+  public:
+    enum Type { Invalid, Rpos, Rref } ;
+
+    static Type type(const char* data, qint64 size ) ;
+
+    // vue RPOS sur 'data', ou nullptr si datagramme invalide
+    static const XPlaneRpos* rpos(const char* data, qint64 size ) ;
+
+    // vue RREF sur 'data', 'count' reçoit le nombre de valeurs (0 si invalide)
+    static const XPlaneRrefValue* rref(const char* data, qint64 size, int& count ) ;
+
+    // construction d'une requête de souscription RREF
+    static void rrefRequest(XPlaneRrefRequest& req, int freq, int index, const char* path ) ;
+
+  private:
+    static bool isAttitudeValid(const XPlaneRpos* rpos ) ;
+} ;
+
+#endif // XPLANEDATAGRAM_H
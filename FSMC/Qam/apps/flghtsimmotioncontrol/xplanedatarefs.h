@@ -0,0 +1,53 @@
+// -----------------------------------------------------------------------
+// xplanedatarefs.h
+// Table des datarefs X-Plane souscrites par requêtes RREF
+// -----------------------------------------------------------------------
+
+#ifndef XPLANEDATAREFS_H
+#define XPLANEDATAREFS_H
+
+#include <QtGlobal>
+
+// indice de souscription = indice dans la table = indice dans l'état
+// (les valeurs reçues sont rangées sans aucune recherche par nom)
+
+enum XPlaneDatarefIndex {
+    DrTheta,		// tangage (degrés)
+    DrPhi,			// roulis (degrés)
+    DrPsi,			// cap vrai (degrés)
+    DrAxil,			// accélération longitudinale (g)
+    DrSide,			// accélération latérale (g)
+    DrNrml,			// accélération normale (g)
+    DrP,			// vitesse de roulis (degrés/s)
+    DrQ,			// vitesse de tangage (degrés/s)
+    DrR,			// vitesse de lacet (degrés/s)
+    DrCount
+} ;
+
+struct XPlaneDataref
+{
+    const char*	path ;		// chemin X-Plane
+    int			freq ;		// fréquence d'émission demandée (Hz)
+} ;
+
+static constexpr XPlaneDataref XPLANE_DATAREFS[DrCount] = {
+    { "sim/flightmodel/position/theta",      50 },
+    { "sim/flightmodel/position/phi",        50 },
+    { "sim/flightmodel/position/psi",        50 },
+    { "sim/flightmodel/forces/g_axil",       50 },
+    { "sim/flightmodel/forces/g_side",       50 },
+    { "sim/flightmodel/forces/g_nrml",       50 },
+    { "sim/flightmodel/position/P",          25 },
+    { "sim/flightmodel/position/Q",          25 },
+    { "sim/flightmodel/position/R",          25 }
+} ;
+
+// Etat reçu (structure de tableaux, indexée par XPlaneDatarefIndex)
+
+struct XPlaneDatarefState
+{
+    float	value[DrCount] ;		// dernière valeur reçue
+    qint64	stamp[DrCount] ;		// date de réception (ms), -1 si jamais reçue
+} ;
+
+#endif // XPLANEDATAREFS_H
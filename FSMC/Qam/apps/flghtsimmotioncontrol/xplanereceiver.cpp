@@ -0,0 +1,272 @@
+// -----------------------------------------------------------------------
+// xplanereceiver.cpp
+// Thread de réception des datagrammes X-Plane et de calcul du MGI
+// -----------------------------------------------------------------------
+
+#include "xplanereceiver.h"
+#include <QUdpSocket>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// -----------------------------------------------------------------------
+// tampon triple
+
+XPlaneSnapshotBuffer::XPlaneSnapshotBuffer()
+    : m_back( 0 )
+    , m_front( 2 )
+    , m_middle( 1 )
+{
+    for ( int i = 0 ; i < 3 ; ++i )	m_buf[i] = XPlaneSnapshot() ;
+}
+
+// l'état écrit devient disponible, l'écrivain récupère l'ancien tampon
+// intermédiaire pour l'écriture suivante
+
+void XPlaneSnapshotBuffer::publish()
+{
+    int prev = m_middle.fetchAndStoreOrdered( m_back | Fresh ) ;
+    m_back = prev & IndexMask ;
+}
+
+// le lecteur échange son tampon avec le tampon intermédiaire s'il
+// contient un état plus récent
+
+bool XPlaneSnapshotBuffer::update()
+{
+    if ( !( m_middle.loadAcquire() & Fresh ) )	return false ;
+
+    int prev = m_middle.fetchAndStoreOrdered( m_front ) ;
+    m_front = prev & IndexMask ;
+    return true ;
+}
+
+// -----------------------------------------------------------------------
+// moteur de réception
+
+XPlaneReceiver::XPlaneReceiver(ModipSlave* slave, const QString& host, quint16 port, QObject* parent )
+    : QThread( parent )
+    , m_slave( slave )
+    , m_host( host )
+    , m_port( port )
+    , m_rposStamp( -1 )
+    , m_rposRequest( -1 )
+    , m_count( 0 )
+    , m_received( 0 )
+    , m_dropped( 0 )
+    , m_superseded( 0 )
+    , m_batches( 0 )
+    , m_subscriptions( 0 )
+{
+    std::memset( &m_pose, 0, sizeof(m_pose) ) ;
+    for ( int i = 0 ; i < 6 ; ++i )	m_len[i] = 0 ;
+    for ( int i = 0 ; i < DrCount ; ++i ) {
+        m_state.value[i] = 0 ;
+        m_state.stamp[i] = -1 ;
+        m_rrefRequest[i] = -1 ;
+    }
+}
+
+XPlaneReceiver::~XPlaneReceiver()
+{
+    requestInterruption() ;
+    wait() ;
+}
+
+// lecture (thread IHM) du dernier état publié, false si rien de nouveau
+
+bool XPlaneReceiver::latest(XPlaneSnapshot& snapshot )
+{
+    bool fresh = m_snapshot.update() ;
+    snapshot = m_snapshot.front() ;
+    return fresh ;
+}
+
+// corps du thread : boucle de réception bloquante (attente bornée pour
+// pouvoir observer la demande d'arrêt), surveillance des flux, puis
+// arrêt des émissions X-Plane en fin de thread
+
+void XPlaneReceiver::run()
+{
+    QUdpSocket  socket ;
+    socket.bind( QHostAddress::AnyIPv4, 0 ) ;	// X-Plane répond au port source
+
+    QByteArray buffer( XPLANE_MAX_DATAGRAM, 0 ) ;	// tampon alloué une seule fois
+
+    m_clock.start() ;
+
+    while ( !isInterruptionRequested() ) {
+        if ( socket.waitForReadyRead( 100 ) )	drain( socket, buffer ) ;
+        watch( socket ) ;
+    }
+
+    subscribeRpos( socket, 0 ) ;
+    for ( int i = 0 ; i < DrCount ; ++i )	subscribeRref( socket, i, 0 ) ;
+}
+
+// [private] lecture de tous les datagrammes en attente : seule la pose
+// la plus récente est conservée, les précédentes sont périmées et un
+// seul calcul MGI est effectué pour le lot ; les valeurs RREF sont
+// rangées directement par leur indice
+
+void XPlaneReceiver::drain(QUdpSocket& socket, QByteArray& buffer )
+{
+    XPlaneRpos  newest ;
+    bool        hasPose = false ;
+    quint32     updated = 0 ;		// datarefs reçues dans ce lot (bit i)
+
+    while ( socket.hasPendingDatagrams() ) {
+        qint64 size = socket.readDatagram( buffer.data(), buffer.size() ) ;
+        if ( size < 0 )	break ;
+        ++m_received ;
+
+        switch ( XPlaneDatagram::type( buffer.constData(), size ) ) {
+        case XPlaneDatagram::Rpos : {
+            const XPlaneRpos* p = XPlaneDatagram::rpos( buffer.constData(), size ) ;
+            if ( p == nullptr ) {
+                ++m_dropped ;
+                break ;
+            }
+            if ( hasPose )	++m_superseded ;
+            newest = *p ;
+            hasPose = true ;
+            break ;
+        }
+        case XPlaneDatagram::Rref : {
+            int count ;
+            const XPlaneRrefValue* values = XPlaneDatagram::rref( buffer.constData(), size, count ) ;
+            if ( values == nullptr )	++m_dropped ;
+            else	dispatch( values, count, updated ) ;
+            break ;
+        }
+        default :
+            ++m_dropped ;
+        }
+    }
+
+    if ( hasPose ) {
+        m_rposStamp = m_clock.elapsed() ;
+        ++m_batches ;
+        process( newest ) ;
+    }
+    if ( hasPose || updated )	publish() ;
+}
+
+// [private] rangement O(1) des valeurs RREF : l'indice reçu est celui de
+// la table XPLANE_DATAREFS, tout indice hors table est rejeté
+
+void XPlaneReceiver::dispatch(const XPlaneRrefValue* values, int count, quint32& updated )
+{
+    qint64 now = m_clock.elapsed() ;
+
+    for ( int i = 0 ; i < count ; ++i ) {
+        quint32 index = quint32( values[i].index ) ;
+        float value = values[i].value ;
+
+        if (( index >= DrCount )||( !std::isfinite( value ) )) {
+            ++m_dropped ;
+            continue ;
+        }
+        if ( updated & ( 1u << index ) )	++m_superseded ;
+        updated |= 1u << index ;
+
+        m_state.value[index] = value ;
+        m_state.stamp[index] = now ;
+    }
+}
+
+// [private] fraîcheur des flux : souscription (ou nouvelle souscription)
+// des flux muets depuis plus de XPLANE_TIMEOUT ms, au plus une requête
+// par flux et par délai
+
+void XPlaneReceiver::watch(QUdpSocket& socket )
+{
+    qint64 now = m_clock.elapsed() ;
+    bool stale = false ;
+
+    if (( m_rposStamp < 0 )||( now - m_rposStamp > XPLANE_TIMEOUT )) {
+        stale = true ;
+        if (( m_rposRequest < 0 )||( now - m_rposRequest > XPLANE_TIMEOUT )) {
+            subscribeRpos( socket, XPLANE_RPOS_FREQ ) ;
+            m_rposRequest = now ;
+        }
+    }
+
+    for ( int i = 0 ; i < DrCount ; ++i ) {
+        if (( m_state.stamp[i] >= 0 )&&( now - m_state.stamp[i] <= XPLANE_TIMEOUT ))	continue ;
+        stale = true ;
+        if (( m_rrefRequest[i] < 0 )||( now - m_rrefRequest[i] > XPLANE_TIMEOUT )) {
+            subscribeRref( socket, i, XPLANE_DATAREFS[i].freq ) ;
+            m_rrefRequest[i] = now ;
+        }
+    }
+
+    if ( stale )	publish() ;		// l'IHM doit voir la perte de flux
+}
+
+// [private] requête "RPOSxxx" (xxx = fréquence en Hz, 0 pour arrêter)
+
+void XPlaneReceiver::subscribeRpos(QUdpSocket& socket, int freq )
+{
+    char req[16] ;
+    int len = std::snprintf( req, sizeof(req), "RPOS%03d", freq ) ;
+    socket.writeDatagram( req, len, m_host, m_port ) ;
+    ++m_subscriptions ;
+}
+
+// [private] requête RREF pour la dataref d'indice 'index'
+
+void XPlaneReceiver::subscribeRref(QUdpSocket& socket, int index, int freq )
+{
+    XPlaneRrefRequest req ;
+    XPlaneDatagram::rrefRequest( req, freq, index, XPLANE_DATAREFS[index].path ) ;
+    socket.writeDatagram( reinterpret_cast<const char*>( &req ), sizeof(req), m_host, m_port ) ;
+    ++m_subscriptions ;
+}
+
+// [private] pose -> registres Modbus -> MGI
+
+void XPlaneReceiver::process(const XPlaneRpos& rpos )
+{
+    float pitch = rpos.pitch ;
+    float heading = rpos.heading ;
+    float roll = rpos.roll ;
+
+    m_slave->setPose( roll, pitch, heading ) ;
+
+    const QamMatrix6x1& len = m_slave->MGI( roll, pitch, heading ) ;
+
+    m_pose = rpos ;
+    for ( int i = 0 ; i < 6 ; ++i )	m_len[i] = len(i) ;
+    ++m_count ;
+}
+
+// [private] publication de l'état complet (le tampon d'écriture est
+// recyclé, tous les champs doivent donc être renseignés)
+
+void XPlaneReceiver::publish()
+{
+    qint64 now = m_clock.elapsed() ;
+
+    XPlaneSnapshot& s = m_snapshot.back() ;
+    s.count = m_count ;
+    s.pitch = m_pose.pitch ;
+    s.heading = m_pose.heading ;
+    s.roll = m_pose.roll ;
+    for ( int i = 0 ; i < 6 ; ++i )	s.len[i] = m_len[i] ;
+
+    s.rrefFresh = true ;
+    for ( int i = 0 ; i < DrCount ; ++i ) {
+        s.dataref[i] = m_state.value[i] ;
+        if (( m_state.stamp[i] < 0 )||( now - m_state.stamp[i] > XPLANE_TIMEOUT ))	s.rrefFresh = false ;
+    }
+    s.rposFresh = ( m_rposStamp >= 0 )&&( now - m_rposStamp <= XPLANE_TIMEOUT ) ;
+
+    s.received = m_received ;
+    s.dropped = m_dropped ;
+    s.superseded = m_superseded ;
+    s.batches = m_batches ;
+    s.subscriptions = m_subscriptions ;
+
+    m_snapshot.publish() ;
+}
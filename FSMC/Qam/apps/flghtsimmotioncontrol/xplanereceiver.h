@@ -0,0 +1,118 @@
+// -----------------------------------------------------------------------
+// xplanereceiver.h
+// Thread de réception des datagrammes X-Plane et de calcul du MGI
+// -----------------------------------------------------------------------
+
+#ifndef XPLANERECEIVER_H
+#define XPLANERECEIVER_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include "modipslave.h"
+#include "xplanedatagram.h"
+#include "xplanedatarefs.h"
+
+class QUdpSocket ;
+
+#define	XPLANE_HOST			"192.168.0.103"
+#define	XPLANE_PORT			49000
+#define	XPLANE_RPOS_FREQ	50		// fréquence des datagrammes RPOS (Hz)
+#define	XPLANE_TIMEOUT		500		// délai de fraîcheur d'un flux (ms)
+
+// Etat publié pour l'affichage (pose reçue et longueurs des vérins)
+// -----------------------------------------------------------------------
+
+struct XPlaneSnapshot
+{
+    quint32 count ;			// nombre de poses traitées depuis le démarrage
+    float   pitch ;			// degrés
+    float   heading ;
+    float   roll ;
+    float   len[6] ;		// longueurs des vérins (mm)
+    float   dataref[DrCount] ;	// valeurs RREF (cf. XPlaneDatarefIndex)
+    bool    rposFresh ;		// flux RPOS actif
+    bool    rrefFresh ;		// toutes les datarefs actives
+    quint32 received ;		// datagrammes lus
+    quint32 dropped ;		// datagrammes rejetés (entête, longueur, valeurs)
+    quint32 superseded ;	// poses valides écartées au profit d'une plus récente
+    quint32 batches ;		// lots traités (un calcul MGI par lot)
+    quint32 subscriptions ;	// requêtes de souscription émises
+} ;
+
+// Tampon triple : l'écrivain (thread de réception) et le lecteur (IHM)
+// ne se bloquent jamais, le lecteur obtient toujours le dernier état
+// complet publié
+// -----------------------------------------------------------------------
+
+class XPlaneSnapshotBuffer
+{
+  public:
+    XPlaneSnapshotBuffer() ;
+
+    XPlaneSnapshot& back() { return m_buf[m_back] ; }
+    void publish() ;				// côté écrivain
+    bool update() ;					// côté lecteur, true si nouvel état
+    const XPlaneSnapshot& front() const { return m_buf[m_front] ; }
+
+  private:
+    enum { Fresh = 4, IndexMask = 3 } ;
+
+    XPlaneSnapshot  m_buf[3] ;
+    int             m_back ;		// propriété de l'écrivain
+    int             m_front ;		// propriété du lecteur
+    QAtomicInt      m_middle ;		// indice échangé | Fresh
+} ;
+
+// Moteur de réception
+// -----------------------------------------------------------------------
+// la socket UDP est créée et servie dans le thread, la pose et les
+// longueurs des vérins y sont calculées puis écrites dans la cartographie
+// Modbus ; l'IHM ne fait que lire le dernier état publié
+// les flux RPOS et RREF sont surveillés : un flux muet depuis plus de
+// XPLANE_TIMEOUT ms est souscrit à nouveau
+
+class XPlaneReceiver : public QThread
+{
+    Q_OBJECT
+
+  public:
+    explicit XPlaneReceiver(ModipSlave* slave, const QString& host = XPLANE_HOST, quint16 port = XPLANE_PORT, QObject* parent = nullptr ) ;
+    ~XPlaneReceiver() ;
+
+    bool latest(XPlaneSnapshot& snapshot ) ;
+
+  protected:
+    void run() override ;
+
+  private:
+    void drain(QUdpSocket& socket, QByteArray& buffer ) ;
+    void dispatch(const XPlaneRrefValue* values, int count, quint32& updated ) ;
+    void watch(QUdpSocket& socket ) ;
+    void subscribeRpos(QUdpSocket& socket, int freq ) ;
+    void subscribeRref(QUdpSocket& socket, int index, int freq ) ;
+    void process(const XPlaneRpos& rpos ) ;
+    void publish() ;
+
+  private:
+    ModipSlave*             m_slave ;
+    QHostAddress            m_host ;
+    quint16                 m_port ;
+    XPlaneSnapshotBuffer    m_snapshot ;
+    QElapsedTimer           m_clock ;
+    XPlaneDatarefState      m_state ;
+    qint64                  m_rposStamp ;			// dernière réception RPOS (ms)
+    qint64                  m_rposRequest ;			// dernière souscription RPOS (ms)
+    qint64                  m_rrefRequest[DrCount] ;	// dernières souscriptions RREF (ms)
+    XPlaneRpos              m_pose ;				// dernière pose valide
+    float                   m_len[6] ;				// longueurs des vérins associées
+    quint32                 m_count ;
+    quint32                 m_received ;
+    quint32                 m_dropped ;
+    quint32                 m_superseded ;
+    quint32                 m_batches ;
+    quint32                 m_subscriptions ;
+} ;
+
+#endif // XPLANERECEIVER_H
@@ -0,0 +1,332 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   qam6dof.h
+ *  description :   INTERFACE et IMPLEMENTATION des classes Qam6Dof
+ *
+ *	project     :	Matrices 6x6 et vecteurs pour 6 degrés de liberté
+ *  start date  :   octobre 2017
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2017-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "Qam6Dof Library"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#ifndef QAM6DOF_H
+#define QAM6DOF_H
+
+#include <cmath>
+
+// 6-DOF (Six Degrees Of Liberty) tools...
+// ---------------------------------------------------------------------------
+// bibliothèque "header-only", types valeur de taille fixe (aucune allocation)
+// Qam6VectorT : vecteur x6, pose [ Tx,Ty,Tz, Rx,Ry,Rz ] ou longueurs des vérins
+// Qam6MatrixT : matrice 6x6, stockage par lignes
+// - opérations combinées (axpy, mult, multAdd...) écrivant dans un opérande
+//   existant : pas de matrice temporaire dans les boucles de calcul
+// - résolution (LU à pivot partiel) et inversion (Gauss-Jordan) en place
+// - constexpr hors racine carrée et fonctions trigonométriques (C++17)
+// ---------------------------------------------------------------------------
+
+#define QAM6DOF_MIN_PIVOT	1e-6	// pivot minimal par défaut (matrice singulière)
+#define QAM6DOF_PI			3.14159265358979323846
+
+// vecteur x6 (ligne ou colonne, indifféremment)
+
+template <typename T> class Qam6VectorT
+{
+  public:
+	constexpr Qam6VectorT() : m_v{ 0, 0, 0, 0, 0, 0 } {}
+	constexpr Qam6VectorT(T v0, T v1, T v2, T v3, T v4, T v5 ) : m_v{ v0, v1, v2, v3, v4, v5 } {}
+
+	constexpr T& operator() (int i ) { return m_v[i] ; }
+	constexpr T  operator() (int i ) const { return m_v[i] ; }
+	constexpr T& operator[] (int i ) { return m_v[i] ; }
+	constexpr T  operator[] (int i ) const { return m_v[i] ; }
+
+	constexpr T* data() { return m_v ; }
+	constexpr const T* data() const { return m_v ; }
+	constexpr const T* constData() const { return m_v ; }
+
+	constexpr void fill(T v ) {
+		for ( int i = 0 ; i < 6 ; ++i )	m_v[i] = v ;
+	}
+	constexpr void set(T v0, T v1, T v2, T v3, T v4, T v5 ) {
+		m_v[0] = v0 ; m_v[1] = v1 ; m_v[2] = v2 ;
+		m_v[3] = v3 ; m_v[4] = v4 ; m_v[5] = v5 ;
+	}
+	constexpr void set(const T* v ) {
+		for ( int i = 0 ; i < 6 ; ++i )	m_v[i] = v[i] ;
+	}
+	constexpr void copyDataTo(T* v ) const {
+		for ( int i = 0 ; i < 6 ; ++i )	v[i] = m_v[i] ;
+	}
+
+	constexpr T dot(const Qam6VectorT& v ) const {
+		T res = 0 ;
+		for ( int i = 0 ; i < 6 ; ++i )	res += m_v[i] * v.m_v[i] ;
+		return res ;
+	}
+	constexpr T squaredNorm() const { return dot( *this ) ; }
+	T norm() const { return std::sqrt( squaredNorm() ) ; }
+
+	// opérations en place
+
+	constexpr Qam6VectorT& operator+=(const Qam6VectorT& v ) {
+		for ( int i = 0 ; i < 6 ; ++i )	m_v[i] += v.m_v[i] ;
+		return *this ;
+	}
+	constexpr Qam6VectorT& operator-=(const Qam6VectorT& v ) {
+		for ( int i = 0 ; i < 6 ; ++i )	m_v[i] -= v.m_v[i] ;
+		return *this ;
+	}
+	constexpr Qam6VectorT& operator*=(T k ) {
+		for ( int i = 0 ; i < 6 ; ++i )	m_v[i] *= k ;
+		return *this ;
+	}
+	// this += a.x
+	constexpr Qam6VectorT& axpy(T a, const Qam6VectorT& x ) {
+		for ( int i = 0 ; i < 6 ; ++i )	m_v[i] += a * x.m_v[i] ;
+		return *this ;
+	}
+	// this = x + a.y
+	constexpr Qam6VectorT& assignAxpy(const Qam6VectorT& x, T a, const Qam6VectorT& y ) {
+		for ( int i = 0 ; i < 6 ; ++i )	m_v[i] = x.m_v[i] + a * y.m_v[i] ;
+		return *this ;
+	}
+	// this += s.( to - this )
+	constexpr Qam6VectorT& lerp(const Qam6VectorT& to, T s ) {
+		for ( int i = 0 ; i < 6 ; ++i )	m_v[i] += s * ( to.m_v[i] - m_v[i] ) ;
+		return *this ;
+	}
+
+	// pose [Tx,Ty,Tz,Rx,Ry,Rz] : conversion des angles, en place ou par copie
+
+	constexpr Qam6VectorT& convertToRadians() {
+		for ( int i = 3 ; i < 6 ; ++i )	m_v[i] *= T( QAM6DOF_PI / 180 ) ;
+		return *this ;
+	}
+	constexpr Qam6VectorT& convertToDegrees() {
+		for ( int i = 3 ; i < 6 ; ++i )	m_v[i] *= T( 180 / QAM6DOF_PI ) ;
+		return *this ;
+	}
+	constexpr Qam6VectorT toRadians() const { Qam6VectorT res = *this ; return res.convertToRadians() ; }
+	constexpr Qam6VectorT toDegrees() const { Qam6VectorT res = *this ; return res.convertToDegrees() ; }
+
+	// compatibilité QamMatrix6x1 / QamMatrix1x6 (sans copie)
+	constexpr const Qam6VectorT& toRow() const { return *this ; }
+	constexpr const Qam6VectorT& toColumn() const { return *this ; }
+
+	friend constexpr Qam6VectorT operator+(Qam6VectorT a, const Qam6VectorT& b ) { return a += b ; }
+	friend constexpr Qam6VectorT operator-(Qam6VectorT a, const Qam6VectorT& b ) { return a -= b ; }
+	friend constexpr Qam6VectorT operator*(T k, Qam6VectorT a ) { return a *= k ; }
+	friend constexpr Qam6VectorT operator*(Qam6VectorT a, T k ) { return a *= k ; }
+
+	friend constexpr bool operator==(const Qam6VectorT& a, const Qam6VectorT& b ) {
+		for ( int i = 0 ; i < 6 ; ++i ) {
+			if ( a.m_v[i] != b.m_v[i] )	return false ;
+		}
+		return true ;
+	}
+	friend constexpr bool operator!=(const Qam6VectorT& a, const Qam6VectorT& b ) { return !( a == b ) ; }
+
+  private:
+	alignas(32) T	m_v[6] ;
+} ;
+
+// matrice 6x6
+
+template <typename T> class Qam6MatrixT
+{
+  public:
+	typedef Qam6VectorT<T>	Vector ;
+
+	constexpr Qam6MatrixT() : m_m{} {}
+
+	static constexpr Qam6MatrixT identity() {
+		Qam6MatrixT res ;
+		res.setToIdentity() ;
+		return res ;
+	}
+
+	constexpr T& operator() (int r, int c ) { return m_m[r][c] ; }
+	constexpr T  operator() (int r, int c ) const { return m_m[r][c] ; }
+
+	constexpr T* row(int r ) { return m_m[r] ; }
+	constexpr const T* row(int r ) const { return m_m[r] ; }
+	constexpr T* data() { return &m_m[0][0] ; }
+	constexpr const T* constData() const { return &m_m[0][0] ; }
+
+	constexpr void fill(T v ) {
+		for ( int r = 0 ; r < 6 ; ++r )
+			for ( int c = 0 ; c < 6 ; ++c )	m_m[r][c] = v ;
+	}
+	constexpr void setToIdentity() {
+		for ( int r = 0 ; r < 6 ; ++r )
+			for ( int c = 0 ; c < 6 ; ++c )	m_m[r][c] = ( r == c ? 1 : 0 ) ;
+	}
+	constexpr void setRow(int r, T v0, T v1, T v2, T v3, T v4, T v5 ) {
+		if (( r < 0 )||( r >= 6 ))	return ;
+		m_m[r][0] = v0 ; m_m[r][1] = v1 ; m_m[r][2] = v2 ;
+		m_m[r][3] = v3 ; m_m[r][4] = v4 ; m_m[r][5] = v5 ;
+	}
+	constexpr void setRow(int r, const T* v ) {
+		if (( r < 0 )||( r >= 6 ))	return ;
+		for ( int c = 0 ; c < 6 ; ++c )	m_m[r][c] = v[c] ;
+	}
+
+	// produits matrice-vecteur, résultat dans 'y' (distinct de 'x')
+
+	// y = M.x
+	constexpr void mult(const Vector& x, Vector& y ) const {
+		for ( int r = 0 ; r < 6 ; ++r )	y(r) = rowDot( r, x ) ;
+	}
+	// y += M.x
+	constexpr void multAdd(const Vector& x, Vector& y ) const {
+		for ( int r = 0 ; r < 6 ; ++r )	y(r) += rowDot( r, x ) ;
+	}
+	// y = transposée(M).x
+	constexpr void multTransposed(const Vector& x, Vector& y ) const {
+		y.fill( 0 ) ;
+		for ( int r = 0 ; r < 6 ; ++r )
+			for ( int c = 0 ; c < 6 ; ++c )	y(c) += m_m[r][c] * x(r) ;
+	}
+	// compatibilité QamMatrix6x6::mult()
+	constexpr Vector mult(const Vector& x ) const {
+		Vector y ;
+		mult( x, y ) ;
+		return y ;
+	}
+
+	// décomposition LU à pivot partiel, en place : M <-- L (diagonale unité,
+	// non stockée) et U ; 'perm' reçoit la permutation des lignes
+	// retourne faux si un pivot est inférieur à 'minPivot' (M indéterminée)
+
+	constexpr bool decompose(int* perm, T minPivot = T( QAM6DOF_MIN_PIVOT ) ) {
+		for ( int i = 0 ; i < 6 ; ++i )	perm[i] = i ;
+
+		for ( int k = 0 ; k < 6 ; ++k ) {
+			int p = pivotRow( k ) ;
+			if ( absolute( m_m[p][k] ) < minPivot )	return false ;
+			if ( p != k ) {
+				swapRows( k, p ) ;
+				int t = perm[k] ; perm[k] = perm[p] ; perm[p] = t ;
+			}
+			for ( int i = k + 1 ; i < 6 ; ++i ) {
+				m_m[i][k] /= m_m[k][k] ;
+				for ( int j = k + 1 ; j < 6 ; ++j )	m_m[i][j] -= m_m[i][k] * m_m[k][j] ;
+			}
+		}
+		return true ;
+	}
+
+	// résolution de L.U.x = P.b après decompose() (b <-- x)
+
+	constexpr void substitute(const int* perm, Vector& b ) const {
+		Vector y ;
+		for ( int i = 0 ; i < 6 ; ++i ) {
+			y(i) = b( perm[i] ) ;
+			for ( int j = 0 ; j < i ; ++j )	y(i) -= m_m[i][j] * y(j) ;
+		}
+		for ( int i = 5 ; i >= 0 ; --i ) {
+			for ( int j = i + 1 ; j < 6 ; ++j )	y(i) -= m_m[i][j] * y(j) ;
+			y(i) /= m_m[i][i] ;
+		}
+		b = y ;
+	}
+
+	// résolution de M.x = b en place (b <-- x, M <-- facteurs LU)
+
+	constexpr bool solve(Vector& b, T minPivot = T( QAM6DOF_MIN_PIVOT ) ) {
+		int perm[6] = { 0, 0, 0, 0, 0, 0 } ;
+		if ( !decompose( perm, minPivot ) )	return false ;
+		substitute( perm, b ) ;
+		return true ;
+	}
+
+	// inversion en place (Gauss-Jordan à pivot partiel)
+	// retourne faux si la matrice est singulière (M indéterminée)
+
+	constexpr bool invert(T minPivot = T( QAM6DOF_MIN_PIVOT ) ) {
+		int piv[6] = { 0, 0, 0, 0, 0, 0 } ;
+
+		for ( int k = 0 ; k < 6 ; ++k ) {
+			int p = pivotRow( k ) ;
+			if ( absolute( m_m[p][k] ) < minPivot )	return false ;
+			if ( p != k )	swapRows( k, p ) ;
+			piv[k] = p ;
+
+			T d = 1 / m_m[k][k] ;
+			m_m[k][k] = 1 ;
+			for ( int j = 0 ; j < 6 ; ++j )	m_m[k][j] *= d ;
+
+			for ( int i = 0 ; i < 6 ; ++i ) {
+				if ( i == k )	continue ;
+				T f = m_m[i][k] ;
+				m_m[i][k] = 0 ;
+				for ( int j = 0 ; j < 6 ; ++j )	m_m[i][j] -= f * m_m[k][j] ;
+			}
+		}
+		// permutations des lignes --> permutations inverses des colonnes
+		for ( int k = 5 ; k >= 0 ; --k ) {
+			if ( piv[k] != k )	swapColumns( k, piv[k] ) ;
+		}
+		return true ;
+	}
+	// compatibilité QamMatrix6x6::inverted()
+	constexpr bool inverted() { return invert() ; }
+
+  private:
+	static constexpr T absolute(T v ) { return ( v < 0 ? -v : v ) ; }
+
+	constexpr T rowDot(int r, const Vector& x ) const {
+		T res = 0 ;
+		for ( int c = 0 ; c < 6 ; ++c )	res += m_m[r][c] * x(c) ;
+		return res ;
+	}
+	constexpr int pivotRow(int k ) const {
+		int p = k ;
+		for ( int i = k + 1 ; i < 6 ; ++i ) {
+			if ( absolute( m_m[i][k] ) > absolute( m_m[p][k] ) )	p = i ;
+		}
+		return p ;
+	}
+	constexpr void swapRows(int r0, int r1 ) {
+		for ( int c = 0 ; c < 6 ; ++c ) {
+			T t = m_m[r0][c] ; m_m[r0][c] = m_m[r1][c] ; m_m[r1][c] = t ;
+		}
+	}
+	constexpr void swapColumns(int c0, int c1 ) {
+		for ( int r = 0 ; r < 6 ; ++r ) {
+			T t = m_m[r][c0] ; m_m[r][c0] = m_m[r][c1] ; m_m[r][c1] = t ;
+		}
+	}
+
+  private:
+	alignas(32) T	m_m[6][6] ;
+} ;
+
+typedef Qam6VectorT<float>		Qam6Vector ;
+typedef Qam6VectorT<double>		Qam6Vectord ;
+typedef Qam6MatrixT<float>		Qam6Matrix ;
+typedef Qam6MatrixT<double>		Qam6Matrixd ;
+
+// noms historiques (classes dérivées de QGenericMatrix jusqu'à la v1.0)
+
+typedef Qam6Vector				QamMatrix6x1 ;	// vecteur ligne x6
+typedef Qam6Vector				QamMatrix1x6 ;	// vecteur colonne x6
+typedef Qam6Matrix				QamMatrix6x6 ;
+
+#endif
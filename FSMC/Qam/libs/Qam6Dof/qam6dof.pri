@@ -0,0 +1,39 @@
+#  ---------------------------------------------------------------------------
+#   filename    :   qam6dof.pri
+#   description :   Qt project file
+#
+#  	project     :	Qam6Dof Library
+#   start date  :   octobre 2017
+#   ---------------------------------------------------------------------------
+#   Copyright 2017-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+#
+#   This file is part of "Qam6Dof Library"
+#
+#   This program is free software ;  you can  redistribute it and/or  modify it
+#   under the terms of the  GNU General Public License as published by the Free
+#   Software Foundation ; either version 3 of the License, or  (at your option)
+#   any later version.
+#
+#   This program is distributed in the hope that it will be useful, but WITHOUT
+#   ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+#   FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+#   more details.
+#
+#  	You should have  received  a copy of the  GNU General Public License  along
+#  	with this program. If not, see <http://www.gnu.org/licenses/>.
+#   ---------------------------------------------------------------------------
+
+# bibliothèque "header-only" : aucun fichier source
+
+CONFIG	+= c++17
+
+INCLUDEPATH += $$PWD
+
+CPPHEADERS	+= $$PWD/Qam6Dof
+
+HEADERS	+= \
+	$$PWD/qam6dof.h
+
+DISTFILES += \
+	$${CPPHEADERS} \
+	$$PWD/_ABOUT $$PWD/_CHANGES $$PWD/_VERSION
@@ -36,6 +36,7 @@ QamModbusData::QamModbusData(const QString& name, quint16 address, bool data16bi
 	: QObject(parent)
 	, m_isWord( data16bits )
 	, m_address( address )
+	, m_store( nullptr )
 {
 	m_words = ( data16bits ? 1 : 0 ) ;
 
@@ -50,6 +51,8 @@ QamModbusData::QamModbusData(const QamModbusData& data )
 {
 	m_isWord = data.m_isWord ;
 	m_address = data.m_address ;
+	m_words = data.m_words ;
+	m_store = data.m_store ;
 	for ( int i = 0 ; i < data.m_items.size() ; ++i )	m_items.append( data.m_items[i] ) ;
 }
 
@@ -59,6 +62,8 @@ QamModbusData& QamModbusData::operator =(const QamModbusData& data )
 {
 	m_isWord = data.m_isWord ;
 	m_address = data.m_address ;
+	m_words = data.m_words ;
+	m_store = data.m_store ;
 	for ( int i = 0 ; i < data.m_items.size() ; ++i )	m_items.append( data.m_items[i] ) ;
 	return *this ;
 }
@@ -112,47 +117,58 @@ void QamModbusData::setComment(const QString& comment, const QString& name )
 
 quint16 QamModbusData::value(int itemId ) const
 {
-	if ( itemId < m_items.size() )	return m_items[itemId].value() ;
-	return 0 ;
+	if (( itemId < 0 )||( itemId >= m_items.size() ))	return 0 ;
+	if ( !m_store )	return m_items[itemId].value() ;
+
+	// donnée liée : valeur extraite du mot de la table
+	quint16 word = m_store->at( m_address ) ;
+	if ( itemId == 0 )	return word ;
+	return ( word & m_items[itemId].mask() ) >> m_items[itemId].offset() ;
 }
 
 quint16 QamModbusData::value(const QString& name ) const
 {
-	for ( int i = 0 ; i < m_items.size() ; ++i ) {
-		if ( m_items[i].name() == name )	return m_items[i].value() ;
-	}
-	return 0 ;
+	return value( itemId( name ) ) ;
 }
 
 bool QamModbusData::setValue(quint16 value, int itemId )
 {
-	if ( itemId >= m_items.size() )	return false ;
-	return setValue( value, m_items[itemId].name() ) ;
+	if (( itemId < 0 )||( itemId >= m_items.size() ))	return false ;
+
+	// donnée liée : seul le mot de la table est modifié (la table n'est jamais
+	// partagée, l'accès constData() évite le contrôle de détachement de data())
+	if ( m_store ) {
+		quint16& word = const_cast<quint16*>( m_store->constData() )[ m_address ] ;
+		if ( itemId == 0 )	word = ( m_isWord ? value : ( value ? 1 : 0 ) ) ;
+		else {
+			word &= ~m_items[itemId].mask() ;
+			word |= ( value << m_items[itemId].offset() ) & m_items[itemId].mask() ;
+		}
+		emit valueChanged( m_items[itemId].name() ) ;
+		return true ;
+	}
+
+	m_items[itemId].setValue( value ) ;
+	quint16 newGlobalValue = m_items[0].value() ;
+	// si affectation globale, mise à jour de la valeur des items
+	if ( itemId == 0 ) {
+		for ( int j = 1 ; j < m_items.size() ; ++j ) {
+			m_items[j].setValue( ( newGlobalValue & m_items[j].mask() ) >> m_items[j].offset() ) ;
+		}
+	}
+	// sinon, mise à jour de la valeur globale
+	else {
+		newGlobalValue &= ~m_items[itemId].mask() ;
+		newGlobalValue |= ( value << m_items[itemId].offset() ) & m_items[itemId].mask() ;
+		m_items[0].setValue( newGlobalValue ) ;
+	}
+	emit valueChanged( m_items[itemId].name() ) ;
+	return true ;
 }
 
 bool QamModbusData::setValue(quint16 value, const QString& name )
 {
-	for ( int i = 0 ; i < m_items.size() ; ++i ) {
-		if ( m_items[i].name() == name ) {
-			m_items[i].setValue( value ) ;
-			quint16 newGlobalValue = m_items[0].value() ;
-			// si affectation globale, mise à jour de la valeur des items
-			if ( i == 0 ) {
-				for ( int j = 1 ; j < m_items.size() ; ++j ) {
-					m_items[j].setValue( ( newGlobalValue & m_items[j].mask() ) >> m_items[j].offset() ) ;
-				}
-			}
-			// sinon, mise à jour de la valeur globale
-			else {
-				newGlobalValue &= ~m_items[i].mask() ;
-				newGlobalValue |= ( value << m_items[i].offset() ) & m_items[i].mask() ;
-				m_items[0].setValue( newGlobalValue ) ;
-			}
-			emit valueChanged( m_items[i].name() ) ;
-			return true ;
-		}
-	}
-	return false ;
+	return setValue( value, itemId( name ) ) ;
 }
 
 // accesseurs masque 16 bits
@@ -213,12 +229,47 @@ bool QamModbusData::setDisplay(const QString& display, const QString& name )
 {
 	for ( int i = 0 ; i < m_items.size() ; ++i ) {
 		if ( m_items[i].name() == name ) {
+			if ( !m_items[i].setDisplay( m_isWord ? display : "Bool" ) )	return false ;
 			if ( i == 0 ) {
-				if (( display == "Float" )||( display == "Long" ))	m_words = 2 ;
-				if ( display == "Str8" )	m_words = 4 ;
-				if ( display == "Str16" )	m_words = 8 ;
+				Display format = m_items[0].format() ;
+				if (( format == Float )||( format == Long ))	m_words = 2 ;
+				if ( format == Str8 )	m_words = 4 ;
+				if ( format == Str16 )	m_words = 8 ;
 			}
-			return m_items[i].setDisplay( m_isWord ? display : "Bool" ) ;
+			return true ;
+		}
+	}
+	return false ;
+}
+
+/*!
+ * Format d'affichage résolu de la donnée primaire ou d'une de ses données
+ * secondaires (new v3.5).
+ * \param itemId : indice de l'élément (0 pour la donnée primaire)
+ * \return Format, Hex si l'élément n'existe pas.
+ */
+
+QamModbusData::Display QamModbusData::displayFormat(int itemId ) const
+{
+	if (( itemId >= 0 )&&( itemId < m_items.size() ))	return m_items[itemId].format() ;
+	return Hex ;
+}
+
+/*!
+ * Conversion d'un nom de format d'affichage en valeur énumérée (new v3.5).
+ * \param display : nom du format ("Hex", "Bool", "Int"...).
+ * \param format : format résolu.
+ * \return false si le nom n'est pas reconnu.
+ */
+
+bool QamModbusData::displayFromString(const QString& display, Display& format )
+{
+	static const char*	names[] = { "Hex", "Bool", "Int", "Uint", "Ascii", "Bcd", "Float", "Long", "Str8", "Str16" } ;
+
+	for ( int i = 0 ; i < 10 ; ++i ) {
+		if ( display == QLatin1String( names[i] ) ) {
+			format = (Display)i ;
+			return true ;
 		}
 	}
 	return false ;
@@ -238,7 +289,7 @@ bool QamModbusData::setDisplay(const QString& display, const QString& name )
 
 QString QamModbusData::valueAsString(int itemId ) const
 {
-	if ( itemId < m_items.size() )	return m_items[itemId].valueAsString() ;
+	if (( itemId >= 0 )&&( itemId < m_items.size() ))	return m_items[itemId].valueAsString( value( itemId ) ) ;
 	return QString("") ;
 }
 
@@ -253,10 +304,26 @@ QString QamModbusData::valueAsString(int itemId ) const
 
 QString QamModbusData::valueAsString(const QString& name ) const
 {
-	for ( int i = 0 ; i < m_items.size() ; ++i ) {
-		if ( m_items[i].name() == name )	return m_items[i].valueAsString() ;
-	}
-	return QString("") ;
+	return valueAsString( itemId( name ) ) ;
+}
+
+// liaison à une table de mots externe (new v2.4)
+// ---------------------------------------------------------------------------
+
+/*!
+ * Liaison de la donnée à une table de mots contiguë indexée par adresse.
+ * La valeur courante est recopiée dans la table, qui devient ensuite
+ * l'unique support de la valeur (les données secondaires en sont extraites
+ * par masque). La table doit contenir l'adresse de la donnée.
+ * \param store : table de mots (une par table primaire).
+ */
+
+void QamModbusData::bind(QVector<quint16>* store )
+{
+	if (( store == nullptr )||( m_address >= store->size() ))	return ;
+
+	store->data()[ m_address ] = m_items[0].value() ;
+	m_store = store ;
 }
 
 // accès aux items d'une donnée 16 bits (item 0 = main item pour 1 ou 16 bits)
@@ -341,6 +408,7 @@ QamModbusDataItem::QamModbusDataItem(const QString& name, quint16 mask, quint16
 	, m_mask( mask )
 	, m_value( value )
 	, m_display( "Hex" )
+	, m_format( QamModbusData::Hex )
 {
 }
 
@@ -361,33 +429,31 @@ bool QamModbusDataItem::setMask(quint16 mask )
 
 bool QamModbusDataItem::setDisplay(const QString& display )
 {
-	if ( display == "Hex" )		{ m_display = display ; return true ; }
-	if ( display == "Bool" )	{ m_display = display ; return true ; }
-	if ( display == "Int" )		{ m_display = display ; return true ; }
-	if ( display == "Uint" )	{ m_display = display ; return true ; }
-	if ( display == "Ascii" )	{ m_display = display ; return true ; }
-	if ( display == "Bcd" )		{ m_display = display ; return true ; }
-
-	if ( display == "Float" )	{ m_display = display ; return true ; }
-	if ( display == "Long" )	{ m_display = display ; return true ; }
-	if ( display == "Str8" )	{ m_display = display ; return true ; }
-	if ( display == "Str16" )	{ m_display = display ; return true ; }
-
-	return false ;
+	// nom conservé pour display(), format résolu pour les accès (new v3.5)
+	if ( !QamModbusData::displayFromString( display, m_format ) )	return false ;
+	m_display = display ;
+	return true ;
 }
 
 QString	QamModbusDataItem::valueAsString() const
 {
-	if ( m_display == "Bool" )	return QString("%1").arg(m_value ? "1" : "0" ) ;
-	if ( m_display == "Int" )	return QString("%1").arg( (qint16)(m_value) ) ;
-	if ( m_display == "Uint" )	return QString("%1").arg( m_value ) ;
-	if ( m_display == "Ascii" ) return QString("%1%2").arg( char( ( m_value >> 8 ) & 0xFF ) ).arg( char( m_value & 0xFF ) ) ;
-	if ( m_display == "Bcd" )	return QString("%1%2%3%4").arg( char( ( ( m_value >> 12 ) & 0xF ) + '0' ) ).arg( char( ( ( m_value >> 8 ) & 0xF ) + '0' ) ).arg( char( ( ( m_value >> 4 ) & 0xF ) + '0' ) ).arg( char( ( m_value & 0x0F ) + '0' ) ) ;
+	return valueAsString( m_value ) ;
+}
+
+// mise en forme d'une valeur quelconque suivant le format de l'élément (new v2.4)
+
+QString	QamModbusDataItem::valueAsString(quint16 value ) const
+{
+	if ( m_format == QamModbusData::Bool )	return QString("%1").arg(value ? "1" : "0" ) ;
+	if ( m_format == QamModbusData::Int )	return QString("%1").arg( (qint16)(value) ) ;
+	if ( m_format == QamModbusData::Uint )	return QString("%1").arg( value ) ;
+	if ( m_format == QamModbusData::Ascii ) return QString("%1%2").arg( char( ( value >> 8 ) & 0xFF ) ).arg( char( value & 0xFF ) ) ;
+	if ( m_format == QamModbusData::Bcd )	return QString("%1%2%3%4").arg( char( ( ( value >> 12 ) & 0xF ) + '0' ) ).arg( char( ( ( value >> 8 ) & 0xF ) + '0' ) ).arg( char( ( ( value >> 4 ) & 0xF ) + '0' ) ).arg( char( ( value & 0x0F ) + '0' ) ) ;
 
 	// pour tous les autres 'display' (morceau de donnée composée),
 	// valeur 16 bits retournée au format 'Hex'
 
-	return QString("%1").arg(m_value, 4, 16, QLatin1Char('0') ).toUpper() ;
+	return QString("%1").arg(value, 4, 16, QLatin1Char('0') ).toUpper() ;
 }
 
 // taille du masque (nb. de bits à 1 adjacents), retourne -1 si non adjacents
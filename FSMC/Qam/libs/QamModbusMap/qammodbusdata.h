@@ -64,6 +64,10 @@ signée sur 32 bits), Str8 (chaine de 8 caractères, codée sur 4 mots) et Str16
 de N mots ; par une donnée primaire de masque $FFFF qui maintient l'adresse de base
 et le format d'affichage, et par N-1 autres données primaires avec les adresses
 suivantes, de masque nul et de format d"affichage forcé à "Hex".
+@n Une donnée peut être liée par bind() à une table de mots contiguë (celle
+de QamModbusMap) : sa valeur est alors lue et écrite directement dans la
+table à l'emplacement de son adresse, la donnée ne conservant que les
+informations descriptives (vue sur la table).
 
 <hr><h2>Propriétés</h2>
 <p>@anchor property_isworddata @c isWordData : vrai si donnée de taille 16 bits.
@@ -114,9 +118,14 @@ ou d'une de ses données secondaires.
 - bool @b setValue (quint16 @a value, int @a itemId = 0 ) ;
 - bool @b setValue (quint16 @a value, const QString& @a name ) ;
 
+<p>Le format d'affichage est résolu une fois pour toutes par setDisplay()
+(displayFormat()) ; les accès numériques typés (QamModbusMap::valueAs(),
+QamModbusMap::setValueAs()) s'appuient sur ce format résolu.
+
  */
 
 #include <QObject>
+#include <QVector>
 
 class QamModbusDataItem ;
 
@@ -125,6 +134,9 @@ class QamModbusData : public QObject
 	Q_OBJECT
 
   public:
+	/*! Formats d'affichage (cf. propriété @ref property_display "display"). */
+	typedef enum { Hex, Bool, Int, Uint, Ascii, Bcd, Float, Long, Str8, Str16 } Display ;	// new v3.5
+
 	explicit QamModbusData(const QString& name, quint16 address, bool data16bits = true, quint16 value = 0, QObject* parent = 0 ) ;
 	QamModbusData(const QamModbusData& data ) ;
 	QamModbusData& operator =(const QamModbusData& data ) ;
@@ -170,6 +182,8 @@ class QamModbusData : public QObject
 	bool setDisplay(const QString& display, int itemId = 0 ) ;
 	/*! Propriété @ref property_display "display". */
 	bool setDisplay(const QString& display, const QString& name ) ;
+	Display displayFormat(int itemId = 0 ) const ;								// new v3.5
+	static bool displayFromString(const QString& display, Display& format ) ;	// new v3.5
 
 	/*! Propriété @ref property_value "value". */
 	quint16 value(int itemId = 0 ) const ;
@@ -183,6 +197,10 @@ class QamModbusData : public QObject
 	QString valueAsString(int itemId = 0 ) const ;
 	QString valueAsString(const QString& name ) const ;
 
+	void bind(QVector<quint16>* store ) ;		// new v2.4
+	/*! Vrai si la valeur est rangée dans une table de mots externe (cf. bind()). */
+	inline bool isBound() const { return m_store != nullptr ; }	// new v2.4
+
 	int itemsNumber() const ;
 	int itemId(const QString& name ) const ;
 	int addItem(const QString& name, quint16 mask, quint16 value = 0 ) ;
@@ -198,6 +216,7 @@ class QamModbusData : public QObject
 	quint16						m_address ;			// Read-Write
 	int							m_words ;			// complete size of value
 	QList<QamModbusDataItem>	m_items ;			// first one is main data...
+	QVector<quint16>*			m_store ;			// table de mots externe (new v2.4)
 } ;
 
 // --------------------------------------------------------------------------------
@@ -234,9 +253,11 @@ class QamModbusDataItem
 	inline void setValue(quint16 value ) { m_value = value ; }
 
 	inline QString display() const { return m_display ; }
+	inline QamModbusData::Display format() const { return m_format ; }		// new v3.5
 	bool setDisplay(const QString& display ) ;
 
 	QString	valueAsString() const ;
+	QString	valueAsString(quint16 value ) const ;	// new v2.4
 
   private:
 	QString		m_name ;		// Read-Write
@@ -244,6 +265,7 @@ class QamModbusDataItem
 	quint16		m_mask ;		// Read-Write
 	quint16		m_value ;		// Read-Write
 	QString		m_display ;		// Read-Write
+	QamModbusData::Display	m_format ;	// 'display' résolu (new v3.5)
 } ;
 
 #endif // QAMMODBUSDATA_H
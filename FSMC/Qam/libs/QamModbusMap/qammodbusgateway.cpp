@@ -0,0 +1,156 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   qammodbusgateway.cpp
+ *  description :   IMPLEMENTATION de la classe QamModbusGateway
+ *					Aiguillage des requêtes Modbus/TCP par Unit Identifier
+ *
+ *	project     :	Qam Modbus over TCP/IP
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2014-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "Qam Modbus over IP Project"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#include "qammodbusgateway.h"
+
+/*! Constructeur. Aucune unité n'est configurée. */
+
+QamModbusGateway::QamModbusGateway(QObject* parent )
+	: QamAbstractServer(parent)
+{
+	for ( int i = 0 ; i < 256 ; ++i )	m_units[i].storeRelaxed( nullptr ) ;
+}
+
+/*!
+ * Association d'une cartographie (mode serveur) à un Unit Identifier.
+ * Les messages info() de la cartographie sont relayés par la passerelle.
+ * \param unitId : Unit Identifier MBAP (0..255).
+ * \param map : cartographie chargée, non possédée par la passerelle.
+ * \return false si @a map est nul ou n'est pas en mode serveur, ou si
+ * l'unité est déjà configurée.
+ */
+
+bool QamModbusGateway::addUnit(quint8 unitId, QamModbusMap* map )
+{
+	if (( map == nullptr )||( map->mode() != QamModbusMap::ServerMode ))	return false ;
+	if ( m_units[ unitId ].loadAcquire() != nullptr )	return false ;
+
+	connect(map, &QamModbusMap::info, this, [this, unitId](const QString& source, const QString& message ) {
+		emit info( QString("unit %1 (%2): %3").arg( unitId ).arg( source ).arg( message ) ) ;
+	} ) ;
+
+	m_units[ unitId ].storeRelease( map ) ;
+	return true ;
+}
+
+/*!
+ * Suppression d'une unité ; les requêtes suivantes qui lui sont adressées
+ * reçoivent l'exception 0A. La cartographie n'est pas détruite.
+ */
+
+void QamModbusGateway::removeUnit(quint8 unitId )
+{
+	QamModbusMap* map = m_units[ unitId ].fetchAndStoreOrdered( nullptr ) ;
+	if ( map )	disconnect(map, &QamModbusMap::info, this, nullptr ) ;
+}
+
+/*! Cartographie associée à un Unit Identifier, ou 0 si aucune. */
+
+QamModbusMap* QamModbusGateway::unit(quint8 unitId ) const
+{
+	return m_units[ unitId ].loadAcquire() ;
+}
+
+/*! Liste des Unit Identifiers configurés. */
+
+QList<quint8> QamModbusGateway::units() const
+{
+	QList<quint8>	list ;
+	for ( int i = 0 ; i < 256 ; ++i ) {
+		if ( m_units[i].loadAcquire() )	list << (quint8)i ;
+	}
+	return list ;
+}
+
+/*!
+ * Compteurs d'une unité depuis la création de la passerelle ou le dernier
+ * appel à resetStatistics() ; les requêtes adressées à une unité non
+ * configurée sont aussi comptabilisées.
+ */
+
+QamModbusGateway::Statistics QamModbusGateway::statistics(quint8 unitId ) const
+{
+	const Counters&	c = m_counters[ unitId ] ;
+
+	Statistics	s ;
+	s.requests = c.requests.loadRelaxed() ;
+	s.exceptions = c.exceptions.loadRelaxed() ;
+	s.rxBytes = c.rxBytes.loadRelaxed() ;
+	s.txBytes = c.txBytes.loadRelaxed() ;
+	return s ;
+}
+
+/*! Remise à zéro des compteurs de toutes les unités. */
+
+void QamModbusGateway::resetStatistics()
+{
+	for ( int i = 0 ; i < 256 ; ++i ) {
+		m_counters[i].requests.storeRelaxed( 0 ) ;
+		m_counters[i].exceptions.storeRelaxed( 0 ) ;
+		m_counters[i].rxBytes.storeRelaxed( 0 ) ;
+		m_counters[i].txBytes.storeRelaxed( 0 ) ;
+	}
+}
+
+/*!
+ * Découpage du flux en trames MBAP (cf. QamModbusPdu::frameLength()).
+ */
+
+int QamModbusGateway::frameLength(const char* data, int size ) const
+{
+	return QamModbusPdu::frameLength( data, size ) ;
+}
+
+/*!
+ * Aiguillage d'une requête vers la cartographie de son Unit Identifier
+ * (méthode invoquée par les connexions de QamTcpServer).
+ * \param request : trame MBAP + PDU complète.
+ * \return Réponse de la cartographie, ou réponse d'exception 0A si l'unité
+ * n'est pas configurée.
+ */
+
+QByteArray QamModbusGateway::responseToClientRequest(QByteArray& request )
+{
+	if ( request.size() < 8 )	return QByteArray() ;		// trame écartée par frameLength()
+
+	quint8		ui = (quint8)request.at(6) ;
+	Counters&	c = m_counters[ ui ] ;
+	QByteArray	response ;
+
+	c.requests.fetchAndAddRelaxed( 1 ) ;
+	c.rxBytes.fetchAndAddRelaxed( request.size() ) ;
+
+	QamModbusMap* map = m_units[ ui ].loadAcquire() ;
+
+	if ( map )	response = map->responseToClientRequest( request ) ;
+	else		response = QamModbusPdu::exceptionResponse( request, 0x0A ) ;
+
+	if (( response.size() > 7 )&&( (quint8)response.at(7) & 0x80 ))	c.exceptions.fetchAndAddRelaxed( 1 ) ;
+	c.txBytes.fetchAndAddRelaxed( response.size() ) ;
+
+	return response ;
+}
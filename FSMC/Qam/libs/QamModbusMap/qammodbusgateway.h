@@ -0,0 +1,113 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   qammodbusgateway.h
+ *  description :   INTERFACE de la classe QamModbusGateway
+ *					Aiguillage des requêtes Modbus/TCP par Unit Identifier
+ *
+ *	project     :	Qam Modbus over TCP/IP
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2014-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "Qam Modbus over IP Project"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#ifndef QAMMODBUSGATEWAY_H
+#define QAMMODBUSGATEWAY_H
+
+/*!
+  @file
+  @brief Passerelle Modbus/TCP : plusieurs cartographies derrière un même port
+ */
+
+/*!
+ @class QamModbusGateway
+ @brief Passerelle Modbus/TCP : plusieurs cartographies derrière un même port.
+
+La classe QamModbusGateway permet de servir plusieurs équipements simulés,
+chacun décrit par son propre objet QamModbusMap (mode serveur), au moyen
+d'un seul objet QamTcpServer. Chaque requête est aiguillée vers la
+cartographie associée à son Unit Identifier (champ UI de l'entête MBAP) ;
+une requête adressée à un UI non configuré reçoit la réponse d'exception
+0A (Gateway Path Unavailable).
+
+Les cartographies sont déclarées par addUnit() avant le démarrage du
+serveur ; l'aiguillage et les statistiques par unité (statistics()) sont
+utilisables depuis les threads de connexion de QamTcpServer.
+
+@code
+	hexapod = new QamModbusMap(QamModbusMap::ServerMode, this ) ;
+	hexapod->loadMap("hexapod.csv") ;
+	cockpit = new QamModbusMap(QamModbusMap::ServerMode, this ) ;
+	cockpit->loadMap("cockpit.csv") ;
+
+	gateway = new QamModbusGateway(this ) ;
+	gateway->addUnit( 1, hexapod ) ;
+	gateway->addUnit( 2, cockpit ) ;
+
+	tcpServer = new QamTcpServer(gateway, this ) ;
+	tcpServer->start( 502 ) ;
+@endcode
+ */
+
+#include "../QamSockets/qamabstractserver.h"
+#include "qammodbusmap.h"
+#include <QAtomicPointer>
+#include <QAtomicInteger>
+
+class QamModbusGateway : public QamAbstractServer
+{
+	Q_OBJECT
+
+  public:
+	/*! Compteurs d'une unité (instantané retourné par statistics()). */
+	struct Statistics {
+		quint32		requests ;		// requêtes reçues
+		quint32		exceptions ;	// réponses d'exception (unité ou cartographie)
+		quint64		rxBytes ;		// octets reçus (MBAP + PDU)
+		quint64		txBytes ;		// octets émis (MBAP + PDU)
+	} ;
+
+	explicit QamModbusGateway(QObject* parent = 0 ) ;
+
+	bool addUnit(quint8 unitId, QamModbusMap* map ) ;
+	void removeUnit(quint8 unitId ) ;
+	QamModbusMap* unit(quint8 unitId ) const ;
+	QList<quint8> units() const ;
+
+	Statistics statistics(quint8 unitId ) const ;
+	void resetStatistics() ;
+
+	virtual int frameLength(const char* data, int size ) const ;
+
+  public slots:
+	virtual QByteArray responseToClientRequest(QByteArray& request ) ;
+
+  private:
+	/* compteurs d'une unité, mis à jour par les threads de connexion */
+	struct Counters {
+		QAtomicInteger<quint32>	requests ;
+		QAtomicInteger<quint32>	exceptions ;
+		QAtomicInteger<quint64>	rxBytes ;
+		QAtomicInteger<quint64>	txBytes ;
+	} ;
+
+  private:
+	QAtomicPointer<QamModbusMap>	m_units[256] ;		// UI -> cartographie (0 si aucune)
+	Counters						m_counters[256] ;
+} ;
+
+#endif // QAMMODBUSGATEWAY_H
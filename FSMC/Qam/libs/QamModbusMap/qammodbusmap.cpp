@@ -26,6 +26,16 @@
  */
 
 #include "qammodbusmap.h"
+#include "../QamSockets/qamtrace.h"
+#include <QtEndian>
+#include <QThread>
+#include <cmath>
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QMetaMethod>
 
 /*! Constructeur. L'argument @a mode permet de spécifier le mode de fonctionnement
  de l'objet.
@@ -45,8 +55,14 @@ QamModbusMap::QamModbusMap(Mode mode, QObject* parent )
 	, m_desc( "" )
 	, m_isServerAvailable( false )
 	, m_mbapTi( 0 )
+	, m_syncTi( 0 )
+	, m_syncPending( false )
 	, m_mbapPi( 0 )
 	, m_mbapUi( 0xFF )
+	, m_seq( 0 )
+	, m_maxInFlight( MODBUSMAP_MAX_INFLIGHT )
+	, m_timeout( MODBUSMAP_TIMEOUT )
+	, m_mapCache( true )
 {
 	m_nullData = new QamModbusData("NULL", 0, true, 0, this ) ;
 
@@ -98,9 +114,17 @@ QString QamModbusMap::tableAsString(PrimaryTable table )
 //QByteArray QamModbusMap::responseToRequest(QByteArray& request )
 QByteArray QamModbusMap::responseToClientRequest(QByteArray& request )
 {
-	QByteArray		resp = request ;
 	PrimaryTable	table = Coil ;
 
+	// état de la requête local à l'appel (new v2.5) : plusieurs connexions
+	// peuvent être servies simultanément par la même cartographie
+	quint8			funct ;
+	quint16			addr ;
+	quint16			number ;
+	quint16			value = 0 ;
+	const char*		pdu = 0 ;		// données FC15 / FC16 (dans la requête)
+	quint8			exception ;
+
 /* commenté 07/2021
     m_exception = 0 ;
 */
@@ -111,30 +135,20 @@ QByteArray QamModbusMap::responseToClientRequest(QByteArray& request )
 		return QByteArray() ;
 	}
 
-    // new 07/2021
-    // une trame tcp peut contenir plusieurs trames MBAP-PDU ...
-    // actuellement cela provoque une sortie avec le message précédent ("invalid MBAP Length") !
-    // et la première trame n'est pas traitée !
-    //
-    quint16		mbapLen = ( (quint8)( request.at(4) ) << 8 ) + (quint8)( request.at(5) ) ;
-    if ( request.count() > ( 6 + mbapLen ) ) {
-        QByteArray ba = request.mid(7) ;
-        responseToClientRequest( ba ) ;
-    }
-    m_exception = 0 ;
-    //
+	// une trame tcp peut contenir plusieurs trames MBAP-PDU, ou une partie
+	// seulement : le découpage est fait en amont par frameLength() (new v2.6)
+	exception = 0 ;
 
-	m_mbapTi  = ( (quint8)( request.at(0) ) << 8 ) + (quint8)( request.at(1) ) ;
-	m_mbapPi  = ( (quint8)( request.at(2) ) << 8 ) + (quint8)( request.at(3) ) ;
-	m_mbapLen = ( (quint8)( request.at(4) ) << 8 ) + (quint8)( request.at(5) ) ;
-	m_mbapUi  =   (quint8)( request.at(6) ) ;
+	const char*	req = request.constData() ;
+	quint16		mbapPi  = QamModbusPdu::get16( req + 2 ) ;
+	quint16		mbapLen = QamModbusPdu::get16( req + 4 ) ;
 
-	if ( m_mbapPi != 0 ) {
+	if ( mbapPi != 0 ) {
 		modbusInfo("invalid MBAP Protocol Identifier") ;
 		return QByteArray() ;
 	}
 
-    if ( request.count() < ( 6 + m_mbapLen ) ) {
+    if ( request.count() < ( 6 + mbapLen ) ) {
 		modbusInfo("invalid MBAP Length") ;
 		return QByteArray() ;
 	}
@@ -147,132 +161,141 @@ QByteArray QamModbusMap::responseToClientRequest(QByteArray& request )
 		return QByteArray() ;
 	}
 */
-	if ( m_verbose ) {
-		QString s ;
-		for ( int i = 7 ; i < request.count() ; ++i ) {
-			s += QString("%1").arg( quint8( request.at(i) ), 2, 16, QLatin1Char('0') ).toUpper() ;
-			s += " " ;
-		}
-		modbusInfo( "recv " + s ) ;
+	if ( isTraced() ) {
+		modbusInfo( "recv " + QamModbusPdu::hexDump( req + 7, request.count() - 7 ) ) ;
+	}
+
+	if ( request.count() < 12 ) {
+		exception = 0x03 ;	// illegal data value
+		return exceptionResponse(request, exception, "missing or incomplete PDU" ) ;
 	}
 
-	m_funct  =   (quint8)( request.at(7) ) ;
-	m_addr   = ( (quint8)( request.at(8) ) << 8 ) + (quint8)( request.at(9) ) ;
-	m_number = 0 ;
-	quint16	nextWord = ( (quint8)( request.at(10) ) << 8 ) + (quint8)( request.at(11) ) ;
+	funct  =   (quint8)( req[7] ) ;
+	addr   = QamModbusPdu::get16( req + 8 ) ;
+	number = 0 ;
+	quint16	nextWord = QamModbusPdu::get16( req + 10 ) ;
 	quint8  n ;
 
-	switch ( m_funct ) {
+	switch ( funct ) {
 	case 1 :
-	case 2 :	table = ( m_funct == 1 ? Coil : DiscretInput ) ;
-				m_number = nextWord ;
-				if (( m_number == 0)||( m_number > 2000 )) {
-					m_exception = 0x02 ;	// illegal data address
-					return exceptionResponse(resp, m_exception, "invalid PDU number" ) ;
+	case 2 :	table = ( funct == 1 ? Coil : DiscretInput ) ;
+				number = nextWord ;
+				if (( number == 0)||( number > 2000 )) {
+					exception = 0x02 ;	// illegal data address
+					return exceptionResponse(request, exception, "invalid PDU number" ) ;
 				}
 				break ;
 	case 3 :
-	case 4 :	table = ( m_funct == 3 ? HoldingRegister : InputRegister ) ;
-				m_number = nextWord ;
-				if (( m_number == 0)||( m_number > 125 )) {
-					m_exception = 0x02 ;	// illegal data address
-					return exceptionResponse(resp, m_exception, "invalid PDU number" ) ;
+	case 4 :	table = ( funct == 3 ? HoldingRegister : InputRegister ) ;
+				number = nextWord ;
+				if (( number == 0)||( number > 125 )) {
+					exception = 0x02 ;	// illegal data address
+					return exceptionResponse(request, exception, "invalid PDU number" ) ;
 				}
 				break ;
 	case 5 :
-	case 6 :	table = ( m_funct == 5 ? Coil : HoldingRegister ) ;
-				m_number = 1 ;
-				m_value  = nextWord ;
+	case 6 :	table = ( funct == 5 ? Coil : HoldingRegister ) ;
+				number = 1 ;
+				value  = nextWord ;
 				break ;
 	case 15 :
-	case 16 :	table = ( m_funct == 15 ? Coil : HoldingRegister ) ;
-				m_number = nextWord ;
-				if (( m_number == 0)||( m_number > ( m_funct == 15 ? 2000 : 120 ) )) {
-					m_exception = 0x02 ;	// illegal data address
-					return exceptionResponse(resp, m_exception, "invalid PDU number" ) ;
+	case 16 :	table = ( funct == 15 ? Coil : HoldingRegister ) ;
+				number = nextWord ;
+				if (( number == 0)||( number > ( funct == 15 ? 2000 : 120 ) )) {
+					exception = 0x02 ;	// illegal data address
+					return exceptionResponse(request, exception, "invalid PDU number" ) ;
 				}
 				if ( request.count() < 13 ) {
-					m_exception = 0x03 ;	// illegal data value
-					return exceptionResponse(resp, m_exception, "PDU data expected" ) ;
+					exception = 0x03 ;	// illegal data value
+					return exceptionResponse(request, exception, "PDU data expected" ) ;
 				}
-				n = (quint8)( request.at(12) ) ;
-				if (( m_funct == 15 )&&( n != ( m_number / 8 + ( m_number % 8 ? 1 : 0 ) ) )) {
-					m_exception = 0x03 ;	// illegal data value
-					return exceptionResponse(resp, m_exception, "invalid PDU data length" ) ;
+				n = (quint8)( req[12] ) ;
+				if (( funct == 15 )&&( n != ( number / 8 + ( number % 8 ? 1 : 0 ) ) )) {
+					exception = 0x03 ;	// illegal data value
+					return exceptionResponse(request, exception, "invalid PDU data length" ) ;
 				}
-				if (( m_funct == 16 )&&( n != ( m_number * 2 ) )) {
-					m_exception = 0x03 ;	// illegal data value
-					return exceptionResponse(resp, m_exception, "invalid PDU data length" ) ;
+				if (( funct == 16 )&&( n != ( number * 2 ) )) {
+					exception = 0x03 ;	// illegal data value
+					return exceptionResponse(request, exception, "invalid PDU data length" ) ;
 				}
 				if ( request.count() != ( 13 + n ) ) {
-					m_exception = 0x03 ;	// illegal data value
-					return exceptionResponse(resp, m_exception, "invalid PDU data count" ) ;
+					exception = 0x03 ;	// illegal data value
+					return exceptionResponse(request, exception, "invalid PDU data count" ) ;
 				}
-				m_data = request.mid(13) ;
+				pdu = req + 13 ;
 				break ;
 
-	default :	m_exception = 0x01 ;	// illegal function
+	default :	exception = 0x01 ;	// illegal function
 	}
 
-	if (( !m_exception )&&( !isRangeAvailable(table, m_addr, m_addr + ( m_number - 1 ) ) )) {
-		m_exception = 0x02 ;			// illegal data address
-		return exceptionResponse(resp, m_exception, "invalid PDU address range" ) ;
+	if (( !exception )&&( !isRangeAvailable(table, addr, addr + ( number - 1 ) ) )) {
+		exception = 0x02 ;			// illegal data address
+		return exceptionResponse(request, exception, "invalid PDU address range" ) ;
 	}
 
-	if ( m_exception ) {
-		return exceptionResponse(resp, m_exception, QString("exception code %1").arg(m_exception ) ) ;
+	if ( exception ) {
+		return exceptionResponse(request, exception, "illegal function" ) ;
 	}
 
-	// trame de réponse
+	// trame de réponse, construite sur la pile (new v3.3)
 
-	modbusInfo( QString("FC %1, Address %2, Number %3").arg(m_funct).arg(m_addr,4,16,QLatin1Char('0')).arg(m_number) ) ;
+	QAMTRACE( QamTrace::Debug, "modbus", "FC %1, Address %x2, Number %3", funct, addr, number ) ;	// new v3.4
 
-	if (( m_funct == 1 )||( m_funct == 2 )) {
-		resp = resp.left(8) ;	// trame reçue jusqu'au Function Code
-		n = m_number / 8 + ( m_number % 8 ? 1 : 0 ) ;
-		resp.append( n ) ;
+	QamModbusFrame	resp ;
+
+	if (( funct == 1 )||( funct == 2 )) {
+		resp.appendFrom( req, 8 ) ;	// trame reçue jusqu'au Function Code
+		n = number / 8 + ( number % 8 ? 1 : 0 ) ;
+		resp.append8( n ) ;
 		quint8 byte = 0 ;
 		quint8 bit = 0 ;
-		for ( int i = 0 ; i < m_number ; ++i ) {
-			quint8 v = ( data(table, m_addr + i ).value() ? 1 : 0 ) ;
+		quint16 bits[ 2000 ] ;
+		readWords(table, addr, number, bits ) ;
+		for ( int i = 0 ; i < number ; ++i ) {
+			quint8 v = ( bits[i] ? 1 : 0 ) ;
 			byte |= v << bit++ ;
-			if (( bit == 8 )||( i == m_number - 1 )) {
-				resp.append( byte ) ;
+			if (( bit == 8 )||( i == number - 1 )) {
+				resp.append8( byte ) ;
 				byte = 0 ;
 				bit = 0 ;
 			}
 		}
 	}
-	else if (( m_funct == 3 )||( m_funct == 4 )) {
-		resp = resp.left(8) ;	// trame reçue jusqu'au Function Code
-		n = m_number * 2 ;
-		resp.append( n ) ;
-		for ( int i = 0 ; i < m_number ; ++i ) {
-			quint16 v = data(table, m_addr + i ).value() ;
-			resp.append( ( v >> 8 ) & 0xFF ) ;
-			resp.append( v & 0xFF ) ;
-		}
-	}
-	else if ( m_funct == 5 ) {
-		QamModbusData& d = data(table, m_addr ) ;
-		d.setValue( m_value ? 1 : 0 ) ;
+	else if (( funct == 3 )||( funct == 4 )) {
+		n = number * 2 ;
+		resp.appendFrom( req, 8 ) ;	// trame reçue jusqu'au Function Code + données
+		resp.append8( n ) ;
+		// instantané cohérent du bloc puis conversion big-endian
+		quint16 words[ 125 ] ;
+		readWords(table, addr, number, words ) ;
+		qToBigEndian<quint16>( words, number, resp.grow( n ) ) ;
+	}
+	else if ( funct == 5 ) {
+		resp.appendFrom( req, 12 ) ;	// écho de la requête
+		QamModbusData& d = data(table, addr ) ;
+		beginWrite() ;
+		d.setValue( value ? 1 : 0 ) ;
+		endWrite() ;
 		emit valueChanged((int)table, d.name() ) ;
 	}
-	else if ( m_funct == 6 ) {
-		QamModbusData& d = data(table, m_addr ) ;
-		d.setValue( m_value ) ;
+	else if ( funct == 6 ) {
+		resp.appendFrom( req, 12 ) ;	// écho de la requête
+		QamModbusData& d = data(table, addr ) ;
+		beginWrite() ;
+		d.setValue( value ) ;
+		endWrite() ;
 		emit valueChanged((int)table, d.name() ) ;
 	}
-	else if ( m_funct == 15 ) {
-		resp = resp.left(12) ;	// trame reçue jusqu'au champ Number
+	else if ( funct == 15 ) {
+		resp.appendFrom( req, 12 ) ;	// trame reçue jusqu'au champ Number
 		quint8 byte = 0 ;
 		quint8 bit = 0 ;
-		for ( int i = 0 ; i < m_number ; ++i ) {
-			QamModbusData& d = data(table, m_addr + i ) ;
+		for ( int i = 0 ; i < number ; ++i ) {
+			QamModbusData& d = data(table, addr + i ) ;
 
-			m_mutex.lock() ;
-			d.setValue( ( m_data[ byte ] >> bit ) & 0x01 ) ;
-			m_mutex.unlock() ;
+			beginWrite() ;
+			d.setValue( ( pdu[ byte ] >> bit ) & 0x01 ) ;
+			endWrite() ;
 
 			emit valueChanged((int)table, d.name() ) ;
 			if ( ++bit == 8 ) {
@@ -281,59 +304,64 @@ QByteArray QamModbusMap::responseToClientRequest(QByteArray& request )
 			}
 		}
 	}
-	else if ( m_funct == 16 ) {
-		resp = resp.left(12) ;	// trame reçue jusqu'au champ Number
-		for ( int i = 0 ; i < m_number ; ++i ) {
-			QamModbusData& d = data(table, m_addr + i ) ;
-			quint16 v = ( (quint8)m_data[ i * 2 ] << 8 ) + (quint8)m_data[ i * 2 + 1 ] ;
+	else if ( funct == 16 ) {
+		resp.appendFrom( req, 12 ) ;	// trame reçue jusqu'au champ Number
+		// copie de bloc avec conversion big-endian
+		beginWrite() ;
+		qFromBigEndian<quint16>( pdu, number, storeWords( table ) + addr ) ;
+		endWrite() ;
 
-			m_mutex.lock() ;
-			d.setValue( v ) ;
-			m_mutex.unlock() ;
-
-			emit valueChanged((int)table, d.name() ) ;
+		for ( int i = 0 ; i < number ; ++i ) {
+			emit valueChanged((int)table, data(table, addr + i ).name() ) ;
 		}
 	}
 
-	m_mbapLen = resp.count() - 6 ;
-	resp[4] = ( m_mbapLen >> 8 ) & 0xFF ;
-	resp[5] =   m_mbapLen & 0xFF ;
+	resp.updateLength() ;
 
-	if ( m_verbose ) {
-		QString s ;
-		for ( int i = 7 ; i < resp.count() ; ++i ) {
-			s += QString("%1").arg( quint8( resp.at(i) ), 2, 16, QLatin1Char('0') ).toUpper() ;
-			s += " " ;
-		}
-		modbusInfo( "send " + s ) ;
+	if ( isTraced() ) {
+		modbusInfo( "send " + QamModbusPdu::hexDump( resp.constData() + 7, resp.size() - 7 ) ) ;
 	}
 
-	return resp ;
+	return resp.toByteArray() ;
+}
+
+/*!
+ * Découpage du flux TCP reçu en trames MBAP-PDU (new v2.6), invoqué par
+ * QamTcpConnection. La longueur d'une trame est donnée par le champ Length
+ * du header MBAP (Unit Identifier + PDU, 254 octets au plus).
+ * \param data : début des données reçues non encore traitées.
+ * \param size : nombre d'octets disponibles.
+ * \return Longueur de la trame complète en tête de @a data, 0 si la trame
+ * est incomplète, -1 si le header MBAP est invalide.
+ */
+
+int QamModbusMap::frameLength(const char* data, int size ) const
+{
+	return QamModbusPdu::frameLength( data, size ) ;
 }
 
 // test l'existence d'une plage d'adresses dans une table primaire [private]
 
 bool QamModbusMap::isRangeAvailable(PrimaryTable table, quint16 addrBegin, quint16 addrEnd )
 {
+	const QVector<qint32>&	idx = m_addrIndex[ table ] ;
+
+	if (( addrBegin > addrEnd )||( addrEnd >= idx.size() ))	return false ;
+
+	const qint32* p = idx.constData() ;
 	for (quint32 r = addrBegin ; r <= addrEnd ; ++r ) {
-		if ( !exists(table, (quint16)r ) )	return false ;
+		if ( p[r] < 0 )	return false ;
 	}
 	return true ;
 }
 
 // fabrique une trame Modbus d'exception [private]
 
-QByteArray QamModbusMap::exceptionResponse(QByteArray& request, quint8 exceptionCode, const QString& message )
+QByteArray QamModbusMap::exceptionResponse(const QByteArray& request, quint8 exceptionCode, const char* message )
 {
-	QByteArray	resp = request.left(9) ;
-	resp[4] = 0 ;
-	resp[5] = 3 ;
-	resp[7] = resp[7] | 0x80 ;
-	resp[8] = exceptionCode ;
-
 	modbusInfo( message ) ;
 
-	return resp ;
+	return QamModbusPdu::exceptionResponse( request, exceptionCode ) ;
 }
 
 // ---------------------------------------------------------------------------
@@ -343,7 +371,10 @@ QByteArray QamModbusMap::exceptionResponse(QByteArray& request, quint8 exception
 /*!
  * Connecteur de traitement d'une réponse serveur Modbus TCP/IP qui doit
  * correspondre à une requête générée par l'émission du signal request() hérité
- * de QamAbstractServer. L'émission et la réception sont synchronisées.
+ * de QamAbstractServer. L'émission et la réception sont synchronisées pour
+ * remoteValue() et setRemoteValue() ; les réponses aux requêtes asynchrones
+ * (readRemoteAsync(), writeRemoteAsync()) sont associées à leur requête par le
+ * Transaction Identifier MBAP.
  * Le signal request() est utilisé par les méthodes remoteValue() et
  * setRemoteValue(), il est déconseillé de l'employer directement en dehors
  * de ces méthodes.
@@ -356,35 +387,62 @@ QByteArray QamModbusMap::exceptionResponse(QByteArray& request, quint8 exception
 //void QamModbusMap::response(QByteArray response )
 void QamModbusMap::responseFromServer(QByteArray response )
 {
-	if ( m_verbose ) {
-		QString s ;
-		for ( int i = 7 ; i < response.count() ; ++i ) {
-			s += QString("%1").arg( quint8( response.at(i) ), 2, 16, QLatin1Char('0') ).toUpper() ;
-			s += " " ;
-		}
-		modbusInfo( "recv " + s ) ;
+	if ( isTraced() ) {
+		modbusInfo( "recv " + QamModbusPdu::hexDump( response.constData() + 7, response.count() - 7 ) ) ;
+	}
+
+	if ( response.count() < 9 ) {
+		modbusInfo("Improper response" ) ;
+		return ;
 	}
 
 	quint16 mbapTi  = ( (quint8)( response.at(0) ) << 8 ) + (quint8)( response.at(1) ) ;
 //	quint16 mbapPi  = ( (quint8)( response.at(2) ) << 8 ) + (quint8)( response.at(3) ) ;
 //	quint16 mbapLen = ( (quint8)( response.at(4) ) << 8 ) + (quint8)( response.at(5) ) ;
 //	quint8  mbapUi  =   (quint8)( response.at(6) ) ;
-	quint8  funct   =   (quint8)( response.at(7) ) ;
 
-	if ( mbapTi != m_mbapTi ) {
-		modbusInfo("Unexpected Transaction Identifier" ) ;
-		emit responseDone() ;
+	// réponse à une requête asynchrone (new v2.7)
+	if ( m_inFlight.contains( mbapTi ) ) {
+		Transaction t = m_inFlight.take( mbapTi ) ;
+		QStringList* changed = ( t.group >= 0 ? &m_pollGroups[ t.group ].changed : 0 ) ;
+		bool ok = applyResponse(response, t.funct, t.addr, t.number, t.value, t.data, changed ) ;
+		finish(t, ok ) ;
 		return ;
 	}
-	if ( funct & 0x80 ) {
-		modbusInfo( QString("Exception %1").arg( (quint8)( response.at(8) ) ) ) ;
-		emit responseDone() ;
+
+	// seule la réponse à la requête synchrone en attente met fin à l'attente ;
+	// une réponse tardive (requête déjà expirée) est ignorée (new v3.6)
+	if (( !m_syncPending )||( mbapTi != m_syncTi )) {
+		modbusInfo("Unexpected Transaction Identifier" ) ;
 		return ;
 	}
-	if ( funct != m_funct ) {
+
+	applyResponse(response, m_funct, m_addr, m_number, m_value, m_data ) ;
+
+	emit responseDone() ;
+}
+
+// [private] mise à jour de la cartographie locale à partir de la réponse
+// à une requête (funct, addr, number, value, data) ; false si exception
+// ou réponse incohérente
+// si 'changed' est fourni (lectures FC1 à FC4), valueChanged() n'est pas
+// émis : les données primaires dont la valeur a changé y sont ajoutées
+
+bool QamModbusMap::applyResponse(const QByteArray& response, quint8 funct, quint16 addr, quint16 number, quint16 value, const QByteArray& data, QStringList* changed )
+{
+	quint8  fc = (quint8)( response.at(7) ) ;
+
+	if ( fc & 0x80 ) {
+		if ( isInfoListened() )	modbusInfo( QString("Exception %1").arg( (quint8)( response.at(8) ) ) ) ;
+		return false ;
+	}
+	if ( fc != funct ) {
 		modbusInfo("Unexpected Function" ) ;
-		emit responseDone() ;
-		return ;
+		return false ;
+	}
+	if (( funct != 1 )&&( funct != 2 )&&( funct != 3 )&&( funct != 4 )&&( response.count() < 12 )) {
+		modbusInfo("Improper response" ) ;
+		return false ;
 	}
 
 	PrimaryTable	table = HoldingRegister ;
@@ -398,102 +456,118 @@ void QamModbusMap::responseFromServer(QByteArray response )
 	// FC1 et FC2 : lecture de données 1 bit
 	if (( funct == 1 )||( funct == 2 )) {
 		quint8 n = (quint8)( response.at(8) ) ;
-		quint8 num = m_number / 8 + ( m_number % 8 ? 1 : 0 ) ;
-		if ( n == num ) {
-			m_data = response.mid(9, n ) ;
+		quint8 num = number / 8 + ( number % 8 ? 1 : 0 ) ;
+		if (( n == num )&&( response.count() >= 9 + n )) {
+			const char* bits = response.constData() + 9 ;
 			quint8 byte = 0 ;
 			quint8 bit = 0 ;
-			for ( int i = 0 ; i < m_number ; ++i ) {
-				QamModbusData& d = data(table, m_addr + i ) ;
-				m_mutex.lock() ;
-				d.setValue( ( m_data[ byte ] >> bit ) & 0x01 ) ;
-				m_mutex.unlock() ;
-				emit valueChanged((int)table, d.name() ) ;
+			for ( int i = 0 ; i < number ; ++i ) {
+				QamModbusData& d = this->data(table, addr + i ) ;
+				quint16 v = ( bits[ byte ] >> bit ) & 0x01 ;
+				if ( changed == 0 ) {
+					beginWrite() ;
+					d.setValue( v ) ;
+					endWrite() ;
+					emit valueChanged((int)table, d.name() ) ;
+				}
+				else if ( d.value() != v ) {
+					beginWrite() ;
+					d.setValue( v ) ;
+					endWrite() ;
+					*changed << d.name() ;
+				}
 				if ( ++bit == 8 ) {
 					bit = 0 ;
 					byte++ ;
 				}
 			}
+			return true ;
 		}
-		else	modbusInfo("Improper response" ) ;
 	}
 	// FC3 et FC4 : lecture de données 16 bits
 	if (( funct == 3 )||( funct == 4 )) {
-		quint8 n      = (quint8)( response.at(8) ) ;
-		quint8 number = m_number ;
-		quint16 addr  = m_addr ;
-		if ( n == number * 2 ) {
-			m_data = response.mid(9, n ) ;
-			// premier élément en dernier pour màj valeur formatée...
-			for ( int i = /*m_number*/number - 1 ; i >= 0 ; --i ) {
-				QamModbusData& d = data(table, /*m_addr*/addr + i ) ;
-				quint16 v = ( (quint8)m_data[ i * 2 ] << 8 ) + (quint8)m_data[ i * 2 + 1 ] ;
-				// if ( i == 0 ) m_value = v ;
-				m_mutex.lock() ;
-				d.setValue( v ) ;
-				m_mutex.unlock() ;
-				emit valueChanged((int)table, d.name() ) ;
+		quint8 n = (quint8)( response.at(8) ) ;
+		if (( n == number * 2 )&&( response.count() >= 9 + n )) {
+			quint16	old[ MODBUSMAP_MAX_WORDS ] ;
+			if ( changed )	std::memcpy( old, m_store[ table ].constData() + addr, qMin<int>( number, MODBUSMAP_MAX_WORDS ) * sizeof(quint16) ) ;
+			// copie de bloc avec conversion big-endian
+			beginWrite() ;
+			qFromBigEndian<quint16>( response.constData() + 9, number, storeWords( table ) + addr ) ;
+			endWrite() ;
+			if ( changed == 0 ) {
+				for ( int i = number - 1 ; i >= 0 ; --i ) {
+					emit valueChanged((int)table, this->data(table, addr + i ).name() ) ;
+				}
+				return true ;
 			}
+			// seuls les mots modifiés sont signalés (une fois par donnée)
+			const quint16* now = m_store[ table ].constData() + addr ;
+			for ( int i = 0 ; ( i < number )&&( i < MODBUSMAP_MAX_WORDS ) ; ++i ) {
+				if ( now[i] == old[i] )	continue ;
+				QString name = this->data(table, addr + i ).name() ;
+				if (( changed->isEmpty() )||( changed->last() != name ))	*changed << name ;
+			}
+			return true ;
 		}
-		else	modbusInfo("Improper response" ) ;
 	}
 	// FC5 et FC6 : response = echo to the request
 	if (( funct == 5 )||( funct == 6 )) {
-		quint16 addr   = ( (quint8)( response.at(8) ) << 8 ) + (quint8)( response.at(9) ) ;
-		quint16 value  = ( (quint8)( response.at(10) ) << 8 ) + (quint8)( response.at(11) ) ;
-
-		if (( value == m_value )&&( addr == m_addr )) {
-			QamModbusData& d = data(table, addr ) ;
-			m_mutex.lock() ;
-			if ( funct == 5 )	d.setValue( value ? 1 : 0 ) ;
-			else				d.setValue( value ) ;
-			m_mutex.unlock() ;
+		quint16 raddr  = ( (quint8)( response.at(8) ) << 8 ) + (quint8)( response.at(9) ) ;
+		quint16 rvalue = ( (quint8)( response.at(10) ) << 8 ) + (quint8)( response.at(11) ) ;
+
+		if (( rvalue == value )&&( raddr == addr )) {
+			QamModbusData& d = this->data(table, raddr ) ;
+			beginWrite() ;
+			if ( funct == 5 )	d.setValue( rvalue ? 1 : 0 ) ;
+			else				d.setValue( rvalue ) ;
+			endWrite() ;
 			emit valueChanged((int)table, d.name() ) ;
+			return true ;
 		}
-		else	modbusInfo("Improper response" ) ;
 	}
 	// FC15 : acquittement écriture données 1 bit
 	if ( funct == 15 ) {
-		quint16 addr   = ( (quint8)( response.at(8) ) << 8 ) + (quint8)( response.at(9) ) ;
-		quint16 number = ( (quint8)( response.at(10) ) << 8 ) + (quint8)( response.at(11) ) ;
+		quint16 raddr   = ( (quint8)( response.at(8) ) << 8 ) + (quint8)( response.at(9) ) ;
+		quint16 rnumber = ( (quint8)( response.at(10) ) << 8 ) + (quint8)( response.at(11) ) ;
 
-		if (( number == m_number )&&( addr == m_addr )) {
+		if (( rnumber == number )&&( raddr == addr )) {
 			quint8 byte = 0 ;
 			quint8 bit = 0 ;
-			for ( int i = 0 ; i < /*m_number*/number ; ++i ) {
-				QamModbusData& d = data(table, /*m_addr*/addr + i ) ;
-				m_mutex.lock() ;
-				d.setValue( ( m_data[ byte ] >> bit ) & 0x01 ) ;
-				m_mutex.unlock() ;
+			for ( int i = 0 ; i < rnumber ; ++i ) {
+				QamModbusData& d = this->data(table, raddr + i ) ;
+				beginWrite() ;
+				d.setValue( ( data[ byte ] >> bit ) & 0x01 ) ;
+				endWrite() ;
 				emit valueChanged((int)table, d.name() ) ;
 				if ( ++bit == 8 ) {
 					bit = 0 ;
 					byte++ ;
 				}
 			}
+			return true ;
 		}
-		else	modbusInfo("Improper response" ) ;
 	}
 	// FC16 : acquittement écriture données 16 bits
 	if ( funct == 16 ) {
-		quint16 addr   = ( (quint8)( response.at(8) ) << 8 ) + (quint8)( response.at(9) ) ;
-		quint16 number = ( (quint8)( response.at(10) ) << 8 ) + (quint8)( response.at(11) ) ;
+		quint16 raddr   = ( (quint8)( response.at(8) ) << 8 ) + (quint8)( response.at(9) ) ;
+		quint16 rnumber = ( (quint8)( response.at(10) ) << 8 ) + (quint8)( response.at(11) ) ;
 
-		if (( number == m_number )&&( addr == m_addr )) {
+		if (( rnumber == number )&&( raddr == addr )) {
 			// premier élément en dernier pour màj valeur formatée...
-			for ( int i = m_number - 1 ; i >= 0 ; --i ) {
-				QamModbusData& d = data(table, /*m_addr*/addr + i ) ;
-				quint16 v = ( (quint8)m_data[ i * 2 ] << 8 ) + (quint8)m_data[ i * 2 + 1 ] ;
-				m_mutex.lock() ;
+			for ( int i = number - 1 ; i >= 0 ; --i ) {
+				QamModbusData& d = this->data(table, raddr + i ) ;
+				quint16 v = ( (quint8)data[ i * 2 ] << 8 ) + (quint8)data[ i * 2 + 1 ] ;
+				beginWrite() ;
 				d.setValue( v ) ;
-				m_mutex.unlock() ;
+				endWrite() ;
 				emit valueChanged((int)table, d.name() ) ;
 			}
+			return true ;
 		}
-		else	modbusInfo("Improper response" ) ;
 	}
 
-	emit responseDone() ;
+	modbusInfo("Improper response" ) ;
+	return false ;
 }
 
 // [private]
@@ -501,6 +575,68 @@ void QamModbusMap::responseFromServer(QByteArray response )
 void QamModbusMap::setServerAvailable(bool serverAvailable )
 {
 	m_isServerAvailable = serverAvailable ;
+
+	if ( serverAvailable )	return ;
+
+	// connexion perdue : échec des requêtes asynchrones en cours (new v2.7)
+	QList<Transaction>	pending = m_inFlight.values() ;
+	while ( !m_waiting.isEmpty() )	pending << m_waiting.dequeue() ;
+	m_inFlight.clear() ;
+
+	for ( int i = 0 ; i < pending.count() ; ++i )	finish(pending[i], false ) ;
+}
+
+// [private] trame MBAP + PDU de requête ; 'number' pour FC1 à FC4 et FC16,
+// 'value' pour FC5 et FC6, 'data' pour FC16
+
+QByteArray QamModbusMap::buildFrame(quint16 ti, quint8 funct, quint16 addr, quint16 number, quint16 value, const QByteArray& data ) const
+{
+	// construction sur la pile, une seule allocation pour la trame émise (new v3.3)
+	QamModbusFrame	frame ;
+	frame.appendMbap( ti, m_mbapPi, m_mbapUi ) ;
+	frame.append8( funct ) ;
+	frame.append16( addr ) ;
+	frame.append16( (( funct == 5 )||( funct == 6 )) ? value : number ) ;
+	if ( funct == 16 ) {
+		frame.append8( (quint8)( number * 2 ) ) ;
+		frame.appendFrom( data.constData(), data.size() ) ;
+	}
+	frame.updateLength() ;
+	return frame.toByteArray() ;
+}
+
+// [private] Transaction Identifier suivant, distinct de ceux des requêtes
+// asynchrones en cours
+
+quint16 QamModbusMap::nextTransactionId()
+{
+	do {
+		m_mbapTi++ ;
+	} while ( m_inFlight.contains( m_mbapTi ) ) ;
+
+	return m_mbapTi ;
+}
+
+// [private] émission d'une requête synchrone et attente de la réponse,
+// bornée par timeout()
+
+void QamModbusMap::waitResponse(const QByteArray& frame )
+{
+	QEventLoop	waitLoop ;
+	QTimer		timer ;
+
+	timer.setSingleShot( true ) ;
+	connect(this, SIGNAL( responseDone() ), &waitLoop, SLOT( quit() ) ) ;
+	connect(&timer, SIGNAL( timeout() ), &waitLoop, SLOT( quit() ) ) ;
+	timer.start( m_timeout ) ;
+
+	m_syncPending = true ;
+	emit request( frame ) ;
+
+	waitLoop.exec() ;
+	m_syncPending = false ;
+
+	if ( !timer.isActive() )	modbusInfo( QString("response timeout (transaction %1)").arg( m_syncTi ) ) ;
 }
 
 // ---------------------------------------------------------------------------
@@ -558,20 +694,8 @@ QStringList QamModbusMap::itemList(const QString& name )
 {
 	QStringList list ;
 
-	for ( int i = 0 ; i < m_holdingRegisters->size() ; ++i ) {
-		QamModbusData data = m_holdingRegisters->at(i) ;
-		if ( data.name() == name ) {
-			for ( int j = 1 ; j < data.itemsNumber() ; ++j )	list << data.name(j) ;
-			return list ;
-		}
-	}
-	for ( int i = 0 ; i < m_inputRegisters->size() ; ++i ) {
-		QamModbusData data = m_inputRegisters->at(i) ;
-		if ( data.name() == name ) {
-			for ( int j = 1 ; j < data.itemsNumber() ; ++j )	list << data.name(j) ;
-			return list ;
-		}
-	}
+	list = itemList(HoldingRegister, name ) ;
+	if ( list.isEmpty() )	list = itemList(InputRegister, name ) ;
 	return list ;
 }
 
@@ -588,14 +712,11 @@ QStringList QamModbusMap::itemList(PrimaryTable table, const QString& name )
 	QStringList list ;
 	if (( table != InputRegister )&&( table != HoldingRegister ))	return list ;
 
-	QList<QamModbusData>*	tbl = ( table == InputRegister ? m_inputRegisters : m_holdingRegisters ) ;
+	const Location* loc = location(table, name ) ;
+	if (( loc == nullptr )||( loc->item ))	return list ;
 
-	for ( int i = 0 ; i < tbl->size() ; ++i ) {
-		QamModbusData data = tbl->at(i) ;
-		if ( data.name() == name ) {
-			for ( int j = 1 ; j < data.itemsNumber() ; ++j )	list << data.name(j) ;
-		}
-	}
+	const QamModbusData& data = tableList( table )->at( loc->index ) ;
+	for ( int j = 1 ; j < data.itemsNumber() ; ++j )	list << data.name(j) ;
 	return list ;
 }
 
@@ -620,17 +741,8 @@ QString QamModbusMap::display(PrimaryTable table, const QString& name )
 
 bool QamModbusMap::exists(PrimaryTable table, const QString& name )
 {
-	QList<QamModbusData>*	tbl = m_holdingRegisters ;
-
-	if ( table == Coil )				tbl = m_coils ;
-	else if ( table == DiscretInput )	tbl = m_discreteInputs ;
-	else if ( table == InputRegister )	tbl = m_inputRegisters ;
-
-	for ( int i = 0 ; i < tbl->size() ; ++i ) {
-		if ( tbl->at(i).name() == name )	return true ;
-	}
-
-	return false ;
+	const Location* loc = location(table, name ) ;
+	return ( loc != nullptr )&&( loc->item == 0 ) ;
 }
 
 /*!
@@ -642,17 +754,7 @@ bool QamModbusMap::exists(PrimaryTable table, const QString& name )
 
 bool QamModbusMap::exists(PrimaryTable table, quint16 address )
 {
-	QList<QamModbusData>*	tbl = m_holdingRegisters ;
-
-	if ( table == Coil )				tbl = m_coils ;
-	else if ( table == DiscretInput )	tbl = m_discreteInputs ;
-	else if ( table == InputRegister )	tbl = m_inputRegisters ;
-
-	for ( int i = 0 ; i < tbl->size() ; ++i ) {
-		if ( tbl->at(i).address() == address )	return true ;
-	}
-
-	return false ;
+	return indexOf(table, address ) >= 0 ;
 }
 
 /*!
@@ -665,17 +767,11 @@ bool QamModbusMap::exists(PrimaryTable table, quint16 address )
 
 QamModbusData& QamModbusMap::data(PrimaryTable table, const QString& name )
 {
-	QList<QamModbusData>*	tbl = m_holdingRegisters ;
+	const Location* loc = location(table, name ) ;
 
-	if ( table == Coil )				tbl = m_coils ;
-	else if ( table == DiscretInput )	tbl = m_discreteInputs ;
-	else if ( table == InputRegister )	tbl = m_inputRegisters ;
+	if (( loc == nullptr )||( loc->item ))	return *m_nullData ;
 
-	for ( int i = 0 ; i < tbl->size() ; ++i ) {
-		if ( tbl->at(i).name() == name )	return tbl->operator [](i) ;
-	}
-
-	return *m_nullData ;
+	return tableList( table )->operator []( loc->index ) ;
 }
 
 /*!
@@ -688,17 +784,68 @@ QamModbusData& QamModbusMap::data(PrimaryTable table, const QString& name )
 
 QamModbusData& QamModbusMap::data(PrimaryTable table, quint16 address )
 {
-	QList<QamModbusData>*	tbl = m_holdingRegisters ;
+	int index = indexOf(table, address ) ;
+
+	if ( index < 0 )	return *m_nullData ;
+
+	return tableList( table )->operator []( index ) ;
+}
+
+/*!
+ * Résolution d'un nom de donnée en référence directe (new v2.2). Le coût de
+ * la recherche par nom est payé une seule fois ; les écritures typées
+ * setLocalValue(const Handle&, ...) accèdent ensuite directement aux mots de
+ * la table, indépendamment de la taille de la cartographie.
+ * \param table : table concernée.
+ * \param name : nom de la donnée primaire / secondaire / composée dans la table.
+ * \return référence résolue, ou référence invalide (isValid() faux) en cas
+ * d'échec.
+ */
+
+QamModbusMap::Handle QamModbusMap::handle(PrimaryTable table, const QString& name )
+{
+	Handle	h ;
+	QString	primary ;
+	int		item ;
+
+	if ( !resolveName(table, name, primary, item ) )	return h ;
+
+	QList<QamModbusData>*	tbl = tableList( table ) ;
+
+	int index = location( table, primary )->index ;
+
+	const QamModbusData&	dta = tbl->at( index ) ;
 
-	if ( table == Coil )				tbl = m_coils ;
-	else if ( table == DiscretInput )	tbl = m_discreteInputs ;
-	else if ( table == InputRegister )	tbl = m_inputRegisters ;
+	h.format = dta.displayFormat( item ) ;
+	switch ( h.format ) {
+	case QamModbusData::Float :
+	case QamModbusData::Long :	h.words = 2 ;	break ;
+	case QamModbusData::Str8 :	h.words = 4 ;	break ;
+	case QamModbusData::Str16 :	h.words = 8 ;	break ;
+	default :	h.words = 1 ;	break ;
+	}
 
-	for ( int i = 0 ; i < tbl->size() ; ++i ) {
-		if ( tbl->at(i).address() == address )	return tbl->operator [](i) ;
+	// les mots suivants d'une donnée composée sont rangés à la suite
+	for ( int i = 1 ; i < h.words ; ++i ) {
+		if ( indexOf( table, dta.address() + i ) != index + i )	return h ;
 	}
 
-	return *m_nullData ;
+	h.table = table ;
+	h.index = index ;
+	h.address = dta.address() ;
+	h.item = item ;
+	h.name = primary ;
+	return h ;
+}
+
+// [private] liste associée à une table primaire
+
+QList<QamModbusData>* QamModbusMap::tableList(PrimaryTable table ) const
+{
+	if ( table == Coil )			return m_coils ;
+	if ( table == DiscretInput )	return m_discreteInputs ;
+	if ( table == InputRegister )	return m_inputRegisters ;
+	return m_holdingRegisters ;
 }
 
 // [private] vérification association 'table' / 'name' [private]
@@ -711,30 +858,30 @@ QamModbusData& QamModbusMap::data(PrimaryTable table, quint16 address )
 
 bool QamModbusMap::checkPrimaryName(PrimaryTable table, const QString& name )
 {
-	QString primaryName = name ;
-	int		itemNumber = -1 ;
-
-	if ( exists(table, name ) ) {				// donnée primaire / composée ?
-		itemNumber = 0 ;						// alors indice toujours 0
-	}
-	else {										// sinon recherche dans liste des
-		QStringList	nl = nameList( table ) ;	// données secondaires
-		for ( int i = 0 ; i < nl.size() ; ++i ) {
-			QStringList il = itemList( nl.at(i) ) ;
-			for ( int j = 0 ; j < il.size() ; ++j ) {
-				if ( il.at(j) == name ) {
-					primaryName = nl.at(i) ;	// donnée primaire
-					itemNumber = j + 1 ;		// item donnée secondaire
-				}
-			}
-		}
-	}
+	QString	primary ;
+	int		item ;
 
-	if ( itemNumber == -1 )	return false ;		// non trouvé...
+	if ( !resolveName(table, name, primary, item ) )	return false ;		// non trouvé...
 
 	m_table = table ;
-	m_name = primaryName ;
-	m_item = itemNumber ;
+	m_name = primary ;
+	m_item = item ;
+	return true ;
+}
+
+// [private] résolution sans effet de bord de 'name' dans 'table' (new v2.5)
+// primary : nom de la donnée primaire
+// item : numéro d'élément ( non nul si 'name' est une donnée secondaire)
+
+bool QamModbusMap::resolveName(PrimaryTable table, const QString& name, QString& primary, int& item ) const
+{
+	const Location* loc = location(table, name ) ;
+
+	if ( loc == nullptr )	return false ;
+
+	// donnée primaire / composée (item 0), ou secondaire de la donnée primaire
+	primary = ( loc->item ? tableList( table )->at( loc->index ).name() : name ) ;
+	item = loc->item ;
 	return true ;
 }
 
@@ -749,32 +896,54 @@ bool QamModbusMap::checkPrimaryName(PrimaryTable table, const QString& name )
 
 bool QamModbusMap::checkFormattedValue(const QamModbusData& data, const QString& value )
 {
-	QString disp = data.display( m_item ) ;
-
 	quint16 compositeValue[8] ;
-	quint16	words = 1 ;
+	quint16	words ;
+
+	if ( !encodeFormattedValue(data, m_item, value, compositeValue, words ) )	return false ;
+
+	m_addr = data.address() ;
+	m_number = words ;
+	m_value = compositeValue[0] ;
+	m_data.clear() ;
+	for ( int i = 0 ; i < m_number ; ++i ) {
+		m_data.append( ( compositeValue[i] >> 8 ) & 0xFF ) ;
+		m_data.append( compositeValue[i] & 0xFF ) ;
+	}
+	return true ;
+}
+
+// [private] conversion sans effet de bord de 'value' suivant le format
+// d'affichage de l'élément 'item' de 'data' (new v2.5)
+// compositeValue : mots à écrire à partir de l'adresse de 'data' (8 au plus)
+// words : nombre de mots
+
+bool QamModbusMap::encodeFormattedValue(const QamModbusData& data, int item, const QString& value, quint16* compositeValue, quint16& words ) const
+{
+	QamModbusData::Display disp = data.displayFormat( item ) ;
+
+	words = 1 ;
 	bool ok = true ;
 
-	if ( disp == "Hex" ) {
+	if ( disp == QamModbusData::Hex ) {
 		compositeValue[0] = value.toUShort(&ok, 16 ) ;
 	}
-	else if ( disp == "Bool" ) {
+	else if ( disp == QamModbusData::Bool ) {
 		compositeValue[0] = ( value.toUInt(&ok, 10 ) ? 1 : 0 ) ;
 	}
-	else if ( disp == "Int" ) {
+	else if ( disp == QamModbusData::Int ) {
 		compositeValue[0] = value.toInt(&ok, 10 ) ;
 	}
-	else if ( disp == "Uint" ) {
+	else if ( disp == QamModbusData::Uint ) {
 		compositeValue[0] = value.toUInt(&ok, 10 ) ;
 	}
-	else if ( disp == "Ascii" ) {
+	else if ( disp == QamModbusData::Ascii ) {
 		QString s = value ;
 		while ( s.size() < 2 )	s = " " + s ;
 		quint8 b1 = s.at(0).toLatin1() ;
 		quint8 b0 = s.at(1).toLatin1() ;
 		compositeValue[0] = ( (quint16)b1 << 8 ) + (quint16)b0 ;
 	}
-	else if ( disp == "Bcd" ) {
+	else if ( disp == QamModbusData::Bcd ) {
 		QString s = value ;
 		while ( s.size() < 4 )	s = "0" + s ;
 		quint8 q3 = s.at(0).toLatin1() - '0' ;
@@ -788,21 +957,21 @@ bool QamModbusMap::checkFormattedValue(const QamModbusData& data, const QString&
 			compositeValue[0] = ( (quint16)q3 << 12 ) + ( (quint16)q2 << 8 ) + ( (quint16)q1 << 4 ) + (quint16)q0 ;
 		}
 	}
-	else if ( disp == "Float" ) {
+	else if ( disp == QamModbusData::Float ) {
 		words = 2 ;
 		float v = value.toFloat(&ok) ;
 		quint16* p = (quint16*)(&v) ;
 		compositeValue[0] = *p ;
 		compositeValue[1] = *(p + 1 ) ;
 	}
-	else if ( disp == "Long" ) {
+	else if ( disp == QamModbusData::Long ) {
 		words = 2 ;
 		qint32 v = value.toLong(&ok, 10 ) ;
 		quint16* p = (quint16*)(&v) ;
 		compositeValue[0] = *p ;
 		compositeValue[1] = *(p + 1 ) ;
 	}
-	else if ( disp == "Str8" ) {
+	else if ( disp == QamModbusData::Str8 ) {
 		words = 4 ;
 		QString s = value ;
 		while ( s.size() < 8 )	s = s + " " ;
@@ -812,7 +981,7 @@ bool QamModbusMap::checkFormattedValue(const QamModbusData& data, const QString&
 			compositeValue[i] = ( (quint16)b1 << 8 ) + (quint16)b0 ;
 		}
 	}
-	else if ( disp == "Str16" ) {
+	else if ( disp == QamModbusData::Str16 ) {
 		words = 8 ;
 		QString s = value ;
 		while ( s.size() < 16 )	s = s + " " ;
@@ -824,17 +993,7 @@ bool QamModbusMap::checkFormattedValue(const QamModbusData& data, const QString&
 	}
 	else return false ;
 
-	if ( !ok ) return false ;
-
-	m_addr = data.address() ;
-	m_number = words ;
-	m_value = compositeValue[0] ;
-	m_data.clear() ;
-	for ( int i = 0 ; i < m_number ; ++i ) {
-		m_data.append( ( compositeValue[i] >> 8 ) & 0xFF ) ;
-		m_data.append( compositeValue[i] & 0xFF ) ;
-	}
-	return true ;
+	return ok ;
 }
 
 // ---------------------------------------------------------------------------
@@ -873,47 +1032,52 @@ void QamModbusMap::setValue(PrimaryTable table, const QString& name, const QStri
 
 void QamModbusMap::setLocalValue(PrimaryTable table, const QString& name, const QString& value )
 {
-	// init. m_table, m_name, m_item
-	if ( !checkPrimaryName(table, name ) ) {
+	// état local à l'appel (new v2.5)
+	QString	primary ;
+	int		item ;
+
+	if ( !resolveName(table, name, primary, item ) ) {
 		modbusInfo( "can't find entry in table" ) ;
 		return ;
 	}
 
-	QamModbusData&	dta = data(m_table, m_name ) ;
+	QamModbusData&	dta = data(table, primary ) ;
 
-	// init. m_addr, m_number, m_value, m_data
-	if ( !checkFormattedValue(dta, value ) ) {
+	quint16	compositeValue[8] ;
+	quint16	words ;
+
+	if ( !encodeFormattedValue(dta, item, value, compositeValue, words ) ) {
 		modbusInfo( "value incompatible with display format" ) ;
-		emit valueChanged((int)m_table, m_name ) ;
+		emit valueChanged((int)table, primary ) ;
 		return ;
 	}
 
+	quint16	addr = dta.address() ;
+
 	switch ( table ) {
 		case Coil :
 		case DiscretInput :
-			m_mutex.lock() ;
-			dta.setValue( m_value ) ;
-			m_mutex.unlock() ;
-			emit valueChanged((int)m_table, m_name ) ;
+			beginWrite() ;
+			dta.setValue( compositeValue[0] ) ;
+			endWrite() ;
+			emit valueChanged((int)table, primary ) ;
 			break ;
 		case InputRegister :
 		default :
-			// compléments d'une donnée composite
-			for ( int i = 1 ; i < m_number ; ++i ) {
-				quint16 val = ( (quint8)m_data[ i * 2 ] << 8 ) + (quint8)m_data[ i * 2 + 1 ] ;
-				m_mutex.lock() ;
-				data(m_table, m_addr + i ).setValue( val ) ;
-				m_mutex.unlock() ;
-				emit valueChanged((int)m_table, data(m_table, m_addr + i ).name() ) ;
+			// tous les mots d'une donnée composite dans la même section
+			// d'écriture : un lecteur ne peut pas observer une valeur partielle
+			beginWrite() ;
+			for ( int i = 1 ; i < words ; ++i )	data(table, addr + i ).setValue( compositeValue[i] ) ;
+			// donnée primaire (item = 0) ou secondaire
+			dta.setValue( compositeValue[0], item ) ;
+			endWrite() ;
+
+			for ( int i = 1 ; i < words ; ++i ) {
+				emit valueChanged((int)table, data(table, addr + i ).name() ) ;
 			}
-			// donnée primaire (m_item = 0) ou secondaire
-			quint16 val = ( (quint8)m_data[ 0 ] << 8 ) + (quint8)m_data[ 1 ] ;
-			m_mutex.lock() ;
-			data(m_table, m_addr ).setValue( val, m_item ) ;
-			m_mutex.unlock() ;
-			emit valueChanged((int)m_table, data(m_table, m_addr ).name( m_item ) ) ;
+			emit valueChanged((int)table, dta.name( item ) ) ;
 			// si donnée secondaire, la primaire doit aussi être actualisée
-			if ( m_item )	emit valueChanged((int)m_table, data(m_table, m_addr ).name() ) ;
+			if ( item )	emit valueChanged((int)table, primary ) ;
 			break ;
 	}
 }
@@ -973,9 +1137,9 @@ void QamModbusMap::setRemoteValue(PrimaryTable table, const QString& name, const
 		buildAndSendReadFrame() ;
 
 		// applique la val. de l'item avec son masque...
-		m_mutex.lock() ;
+		beginWrite() ;
 		data(m_table, m_addr ).setValue(val, item ) ;
-		m_mutex.unlock() ;
+		endWrite() ;
 		// ... et récupère la nouvelle vaL de la donnée primaire
 		m_value = data(m_table, m_addr ).value() ;
 	}
@@ -997,148 +1161,378 @@ void QamModbusMap::setRemoteValue(PrimaryTable table, const QString& name, const
 
 void QamModbusMap::buildAndSendWriteFrame()
 {
-	m_mbapTi++ ;
-	m_mbapLen = ( m_funct == 16 ? 7 + m_number * 2 : 6 ) ;
-	QByteArray	frame ;
-	frame.append( ( m_mbapTi >> 8 ) & 0xFF ) ;
-	frame.append( m_mbapTi & 0xFF ) ;
-	frame.append( ( m_mbapPi >> 8 ) & 0xFF ) ;
-	frame.append( m_mbapPi & 0xFF ) ;
-	frame.append( ( m_mbapLen >> 8 ) & 0xFF ) ;
-	frame.append( m_mbapLen & 0xFF ) ;
-	frame.append( m_mbapUi ) ;
-	frame.append( m_funct ) ;
-	frame.append( ( m_addr >> 8 ) & 0xFF ) ;
-	frame.append( m_addr & 0xFF ) ;
-	if ( m_funct == 16 ) {
-		frame.append( ( m_number >> 8 ) & 0xFF ) ;
-		frame.append( m_number & 0xFF ) ;
-		frame.append( (quint8)( m_number * 2 ) ) ;
-		frame.append( m_data ) ;
-	}
-	else {
-		frame.append( ( m_value >> 8 ) & 0xFF ) ;
-		frame.append( m_value & 0xFF ) ;
-	}
+	m_syncTi = nextTransactionId() ;
+	QByteArray	frame = buildFrame(m_syncTi, m_funct, m_addr, m_number, m_value, m_data ) ;
 
-	if ( m_verbose ) {
-		QString s ;
-		for ( int i = 7 ; i < frame.count() ; ++i ) {
-			s += QString("%1").arg( quint8( frame.at(i) ), 2, 16, QLatin1Char('0') ).toUpper() ;
-			s += " " ;
-		}
-		modbusInfo( "send " + s + " ( W: " + m_name + " )" ) ;
+	if ( isTraced() ) {
+		modbusInfo( "send " + QamModbusPdu::hexDump( frame.constData() + 7, frame.count() - 7 ) + " ( W: " + m_name + " )" ) ;
 	}
 
-	QEventLoop waitLoop ;
-	connect(this, SIGNAL( responseDone() ), &waitLoop, SLOT( quit() ) ) ;
+	waitResponse( frame ) ;
+}
 
-	emit request( frame ) ;
+/*!
+ * Ecriture typée d'une donnée de la cartographie locale par référence
+ * pré-résolue (new v2.2). La valeur est convertie suivant le format de la
+ * donnée (arrondie pour les formats entiers, bornée à leur intervalle) ;
+ * les formats Ascii, Str8 et Str16 ne sont pas pris en charge.
+ * Un seul verrouillage de la cartographie est effectué.
+ * \param handle : référence obtenue par handle().
+ * \param value : nouvelle valeur.
+ * \return false si référence invalide ou format non pris en charge.
+ */
 
-	waitLoop.exec() ;
+bool QamModbusMap::setLocalValue(const Handle& handle, float value )
+{
+	return setNumericValue(handle, value ) ;
 }
 
-// ---------------------------------------------------------------------------
-// sélecteurs de données Modbus
-// ---------------------------------------------------------------------------
-
 /*!
- * Valeur mise en forme suivant le format d'affichage d'une donnée. Cette méthode
- * est équivalente à localValue() en mode serveur ou à remoteValue() en mode client.
- * \param table : table concernée.
- * \param name : nom de la donnée primaire dans la table.
- * \return Chaine de caractères, ou chaine vide en cas d'échec.
+ * Ecriture typée d'une donnée de la cartographie locale par référence
+ * pré-résolue, en double précision (new v3.5) ; utilisée par le modèle
+ * setValueAs<T>(). Mêmes règles de conversion que setLocalValue().
+ * \param handle : référence obtenue par handle().
+ * \param value : nouvelle valeur.
+ * \return false si référence invalide ou format non pris en charge.
  */
 
-QString QamModbusMap::value(PrimaryTable table, const QString& name )
+bool QamModbusMap::setNumericValue(const Handle& handle, double value )
 {
-	if ( m_mode == ServerMode )	return localValue(table, name ) ;
-	if ( m_mode == ClientMode )	return remoteValue(table, name ) ;
-	return QString("") ;
+	quint16	words[2] ;
+	if ( !encodeValue(handle, value, words ) )	return false ;
+
+	beginWrite() ;
+	writeWords(handle, words ) ;
+	endWrite() ;
+
+	emitValueChanged( handle ) ;
+	return true ;
 }
 
 /*!
- * Sélecteur de donnée dans la cartographie locale. Cette méthode est utilisable
- * dans les deux modes (serveur ou client). La valeur retournée est mise en forme
- * suivant le format d'affichage de la donnée.
- * \param table : table concernée.
- * \param name : nom de la donnée primaire / secondaire / composée dans la table.
- * \return Chaine de caractères, ou chaine vide en cas d'échec.
+ * Ecriture typée d'une valeur entière 16 bits signée (new v2.2).
+ * \see setLocalValue(const Handle&, float)
  */
 
-QString QamModbusMap::localValue(PrimaryTable table, const QString& name )
+bool QamModbusMap::setLocalValue(const Handle& handle, qint16 value )
 {
-	// init. m_table, m_name, m_item
-	if ( !checkPrimaryName(table, name ) ) {
-		modbusInfo( "can't find entry in table" ) ;
-		return QString("") ;
-	}
+	quint16	words[2] ;
+	if ( !encodeValue(handle, value, words ) )	return false ;
 
-	// accès à la donnée primaire de base
-	QamModbusData&	dta = data(m_table, m_name ) ;
+	beginWrite() ;
+	writeWords(handle, words ) ;
+	endWrite() ;
 
-	// donnée secondaire demandée (16 bits) ?
-	if ( m_item )	return dta.valueAsString( m_item ) ;
+	emitValueChanged( handle ) ;
+	return true ;
+}
 
-	// sinon, est-ce une donnée composée (N x 16 bits) ?
-	m_addr = dta.address() ;
-	quint16	compositeValue[8] ;
+/*!
+ * Ecriture groupée de @a count données sous un seul verrouillage de la
+ * cartographie (new v2.2) : un lecteur concurrent (requête client) obtient
+ * soit l'ensemble des anciennes valeurs, soit l'ensemble des nouvelles.
+ * \param handles : tableau de références obtenues par handle().
+ * \param values : tableau des nouvelles valeurs.
+ * \param count : nombre de données.
+ * \return false si une des références est invalide (aucune écriture).
+ */
 
-	if ( dta.display() == "Float" ) {
-		compositeValue[0] = data(m_table, m_addr ).value() ;
-		compositeValue[1] = data(m_table, m_addr + 1 ).value() ;
-		float v = *( (float*)compositeValue ) ;
-		return QString("%1").arg( v ) ;
-	}
-	else if ( dta.display() == "Long" ) {
-		compositeValue[0] = data(m_table, m_addr ).value() ;
-		compositeValue[1] = data(m_table, m_addr + 1 ).value() ;
-		qint32 v = *( (qint32*)compositeValue ) ;
-		return QString("%1").arg( v ) ;
-	}
-	else if ( dta.display() == "Str8" ) {
-		QString res ;
-		for (int i = 0 ; i < 4 ; ++i ) {
-			compositeValue[i] = data(m_table, m_addr + i ).value() ;
-			res += (char)( ( compositeValue[i] >> 8 ) & 0xFF ) ;
-			res += (char)( compositeValue[i] & 0xFF ) ;
-		}
-		return res ;
-	}
-	else if ( dta.display() == "Str16" ) {
-		QString res ;
-		for (int i = 0 ; i < 8 ; ++i ) {
-			compositeValue[i] = data(m_table, m_addr + i ).value() ;
-			res += (char)( ( compositeValue[i] >> 8 ) & 0xFF ) ;
-			res += (char)( compositeValue[i] & 0xFF ) ;
-		}
-		return res ;
+bool QamModbusMap::setLocalValues(const Handle* handles, const float* values, int count )
+{
+	quint16	words[2 * MODBUSMAP_MAX_BATCH] ;
+
+	if (( count <= 0 )||( count > MODBUSMAP_MAX_BATCH ))	return false ;
+
+	for ( int i = 0 ; i < count ; ++i ) {
+		if ( !encodeValue(handles[i], values[i], &words[ 2 * i ] ) )	return false ;
 	}
-	// sinon c'est une donnée primaire (1 ou 16 bits), m_item = 0
-	return dta.valueAsString() ;
+
+	beginWrite() ;
+	for ( int i = 0 ; i < count ; ++i )	writeWords(handles[i], &words[ 2 * i ] ) ;
+	endWrite() ;
+
+	for ( int i = 0 ; i < count ; ++i )	emitValueChanged( handles[i] ) ;
+	return true ;
 }
 
 /*!
- * Sélecteur de donnée par interrogation du serveur (sans effet en mode serveur
- * ou si aucune connexion n'est active). La cartographie locale est mise à jour
- * et la valeur retournée est mise en forme suivant le format d'affichage de la
- * donnée.
+ * Ecriture de mots bruts de la cartographie locale sous un seul verrouillage
+ * (new v3.6) : un lecteur concurrent obtient soit l'ensemble des anciennes
+ * valeurs, soit l'ensemble des nouvelles. Le signal valuesChanged() est
+ * ensuite émis une fois pour les données dont la valeur a changé (cas des
+ * changements reçus par QamModbusPushClient).
  * \param table : table concernée.
- * \param name : nom de la donnée primaire dans la table.
- * \return Chaine de caractères, ou chaine vide en cas d'échec.
+ * \param addresses : adresses des mots.
+ * \param values : nouvelles valeurs (0 ou 1 pour les tables de bits).
+ * \param count : nombre de mots.
+ * \return false si une adresse est hors table (aucune écriture).
  */
 
-QString QamModbusMap::remoteValue(PrimaryTable table, const QString& name )
+bool QamModbusMap::setLocalWords(PrimaryTable table, const quint16* addresses, const quint16* values, int count )
 {
-	if ( m_mode != ClientMode )		return QString("") ;
+	const int	size = m_store[ table ].size() ;
 
-	// init. m_table, m_name, m_item
-	if ( !checkPrimaryName(table, name ) ) {
-		modbusInfo( "can't find entry in table" ) ;
-		return QString("") ;
+	for ( int i = 0 ; i < count ; ++i ) {
+		if ( addresses[i] >= size )	return false ;
 	}
 
-	if ( !m_isServerAvailable )	{
+	const QList<QamModbusData>&	tbl = *tableList( table ) ;
+	QStringList					names ;
+
+	beginWrite() ;
+	quint16* store = storeWords( table ) ;
+	for ( int i = 0 ; i < count ; ++i ) {
+		if ( store[ addresses[i] ] == values[i] )	continue ;
+		store[ addresses[i] ] = values[i] ;
+		int index = indexOf( table, addresses[i] ) ;
+		if ( index < 0 )	continue ;
+		const QString& name = tbl.at( index ).name() ;
+		if (( names.isEmpty() )||( names.last() != name ))	names << name ;
+	}
+	endWrite() ;
+
+	if ( !names.isEmpty() )	emit valuesChanged( (int)table, names ) ;
+	return true ;
+}
+
+// [private] conversion d'une valeur numérique en mots suivant le format
+// de la référence (même représentation mémoire que encodeFormattedValue())
+
+bool QamModbusMap::encodeValue(const Handle& handle, double value, quint16* words ) const
+{
+	if ( !handle.isValid() )	return false ;
+
+	switch ( handle.format ) {
+	case QamModbusData::Bool :
+		words[0] = ( value != 0 ? 1 : 0 ) ;
+		return true ;
+	case QamModbusData::Int :
+		words[0] = (quint16)(qint16)qBound( -32768.0, std::round( value ), 32767.0 ) ;
+		return true ;
+	case QamModbusData::Hex :
+	case QamModbusData::Uint :
+		words[0] = (quint16)qBound( 0.0, std::round( value ), 65535.0 ) ;
+		return true ;
+	case QamModbusData::Bcd : {
+		int n = (int)qBound( 0.0, std::round( value ), 9999.0 ) ;
+		words[0] = ( ( n / 1000 ) << 12 ) | ( ( n / 100 % 10 ) << 8 ) | ( ( n / 10 % 10 ) << 4 ) | ( n % 10 ) ;
+		return true ;
+	}
+	case QamModbusData::Float : {
+		float v = (float)value ;
+		std::memcpy( words, &v, sizeof(v) ) ;
+		return true ;
+	}
+	case QamModbusData::Long : {
+		qint32 v = (qint32)qBound( -2147483648.0, std::round( value ), 2147483647.0 ) ;
+		std::memcpy( words, &v, sizeof(v) ) ;
+		return true ;
+	}
+	default :
+		return false ;
+	}
+}
+
+// [private] écriture directe des mots d'une donnée (section d'écriture à
+// la charge de l'appelant, cf. beginWrite())
+
+void QamModbusMap::writeWords(const Handle& handle, const quint16* words )
+{
+	// donnée primaire ou composée : écriture directe dans la table de mots
+	if ( handle.item == 0 ) {
+		quint16* store = storeWords( handle.table ) + handle.address ;
+		for ( int i = 0 ; i < handle.words ; ++i )	store[i] = words[i] ;
+		return ;
+	}
+	// donnée secondaire : application du masque par la vue
+	( *tableList( handle.table ) )[ handle.index ].setValue( words[0], handle.item ) ;
+}
+
+// [private] notification des changements de valeur (cf. setLocalValue())
+
+void QamModbusMap::emitValueChanged(const Handle& handle )
+{
+	const QList<QamModbusData>&	tbl = *tableList( handle.table ) ;
+
+	for ( int i = 1 ; i < handle.words ; ++i ) {
+		emit valueChanged((int)handle.table, tbl.at( handle.index + i ).name() ) ;
+	}
+	if ( handle.item )	emit valueChanged((int)handle.table, tbl.at( handle.index ).name( handle.item ) ) ;
+	emit valueChanged((int)handle.table, handle.name ) ;
+}
+
+// ---------------------------------------------------------------------------
+// cohérence de l'image des registres (new v2.5)
+// ---------------------------------------------------------------------------
+// les écrivains sont sérialisés par m_mutex et encadrent chaque modification
+// par deux incréments du compteur de séquence m_seq (impair pendant
+// l'écriture) ; les lecteurs ne prennent aucun verrou : ils copient les mots
+// puis recommencent si une écriture a eu lieu pendant la copie
+
+// [private] ouverture d'une section d'écriture
+
+void QamModbusMap::beginWrite()
+{
+	m_mutex.lock() ;
+	m_seq.fetchAndAddOrdered( 1 ) ;
+}
+
+// [private] fermeture d'une section d'écriture
+
+void QamModbusMap::endWrite()
+{
+	m_seq.fetchAndAddOrdered( 1 ) ;
+	m_mutex.unlock() ;
+}
+
+// [private] instantané cohérent de 'count' mots consécutifs d'une table à
+// partir de l'adresse 'address' (plage vérifiée par l'appelant)
+
+void QamModbusMap::readWords(PrimaryTable table, quint16 address, int count, quint16* dest ) const
+{
+	quint32 seq ;
+
+	do {
+		// écriture en cours : les sections d'écriture sont brèves
+		while ( ( seq = m_seq.loadAcquire() ) & 1 )	QThread::yieldCurrentThread() ;
+		const quint16* src = m_store[ table ].constData() + address ;
+		std::memcpy( dest, src, count * sizeof(quint16) ) ;
+		std::atomic_thread_fence( std::memory_order_acquire ) ;
+	} while ( m_seq.loadRelaxed() != seq ) ;
+}
+
+// [private] mots d'une table pour un écrivain (section d'écriture ouverte)
+// les tables ne sont jamais partagées (QamModbusMap non copiable) et ne sont
+// redimensionnées qu'à la construction de la cartographie : le pointeur est
+// pris sans passer par QVector::data(), qui peut provoquer une copie
+
+quint16* QamModbusMap::storeWords(PrimaryTable table )
+{
+	return const_cast<quint16*>( m_store[ table ].constData() ) ;
+}
+
+// ---------------------------------------------------------------------------
+// sélecteurs de données Modbus
+// ---------------------------------------------------------------------------
+
+/*!
+ * Valeur mise en forme suivant le format d'affichage d'une donnée. Cette méthode
+ * est équivalente à localValue() en mode serveur ou à remoteValue() en mode client.
+ * \param table : table concernée.
+ * \param name : nom de la donnée primaire dans la table.
+ * \return Chaine de caractères, ou chaine vide en cas d'échec.
+ */
+
+QString QamModbusMap::value(PrimaryTable table, const QString& name )
+{
+	if ( m_mode == ServerMode )	return localValue(table, name ) ;
+	if ( m_mode == ClientMode )	return remoteValue(table, name ) ;
+	return QString("") ;
+}
+
+/*!
+ * Sélecteur de donnée dans la cartographie locale. Cette méthode est utilisable
+ * dans les deux modes (serveur ou client). La valeur retournée est mise en forme
+ * suivant le format d'affichage de la donnée.
+ * \param table : table concernée.
+ * \param name : nom de la donnée primaire / secondaire / composée dans la table.
+ * \return Chaine de caractères, ou chaine vide en cas d'échec.
+ */
+
+QString QamModbusMap::localValue(PrimaryTable table, const QString& name )
+{
+	// état local à l'appel (new v2.5)
+	QString	primary ;
+	int		item ;
+
+	if ( !resolveName(table, name, primary, item ) ) {
+		modbusInfo( "can't find entry in table" ) ;
+		return QString("") ;
+	}
+
+	// accès à la donnée primaire de base
+	QamModbusData&	dta = data(table, primary ) ;
+
+	// donnée secondaire demandée (16 bits) ?
+	if ( item )	return dta.valueAsString( item ) ;
+
+	// sinon, est-ce une donnée composée (N x 16 bits) ?
+	// les mots sont lus en un seul instantané cohérent
+	quint16	addr = dta.address() ;
+	quint16	compositeValue[8] ;
+	QamModbusData::Display	format = dta.displayFormat() ;
+
+	if ( format == QamModbusData::Float ) {
+		readWords(table, addr, 2, compositeValue ) ;
+		float v = *( (float*)compositeValue ) ;
+		return QString("%1").arg( v ) ;
+	}
+	else if ( format == QamModbusData::Long ) {
+		readWords(table, addr, 2, compositeValue ) ;
+		qint32 v = *( (qint32*)compositeValue ) ;
+		return QString("%1").arg( v ) ;
+	}
+	else if ( format == QamModbusData::Str8 ) {
+		QString res ;
+		readWords(table, addr, 4, compositeValue ) ;
+		for (int i = 0 ; i < 4 ; ++i ) {
+			res += (char)( ( compositeValue[i] >> 8 ) & 0xFF ) ;
+			res += (char)( compositeValue[i] & 0xFF ) ;
+		}
+		return res ;
+	}
+	else if ( format == QamModbusData::Str16 ) {
+		QString res ;
+		readWords(table, addr, 8, compositeValue ) ;
+		for (int i = 0 ; i < 8 ; ++i ) {
+			res += (char)( ( compositeValue[i] >> 8 ) & 0xFF ) ;
+			res += (char)( compositeValue[i] & 0xFF ) ;
+		}
+		return res ;
+	}
+	// sinon c'est une donnée primaire (1 ou 16 bits), item = 0
+	return dta.valueAsString() ;
+}
+
+/*!
+ * Lecture typée d'une donnée de la cartographie locale par référence
+ * pré-résolue (new v3.5), sans mise en forme : les mots de la donnée sont lus
+ * en un seul instantané cohérent puis décodés suivant son format (Hex, Bool,
+ * Int, Uint, Bcd, Float ou Long) ; utilisée par le modèle valueAs<T>().
+ * \param handle : référence obtenue par handle().
+ * \return Valeur, 0 si référence invalide ou format non pris en charge.
+ */
+
+double QamModbusMap::numericValue(const Handle& handle ) const
+{
+	if ( !handle.isNumeric() )	return 0 ;
+
+	quint16	words[2] ;
+	readWords(handle.table, handle.address, handle.words, words ) ;
+	return decodeValue(handle, words ) ;
+}
+
+/*!
+ * Sélecteur de donnée par interrogation du serveur (sans effet en mode serveur
+ * ou si aucune connexion n'est active). La cartographie locale est mise à jour
+ * et la valeur retournée est mise en forme suivant le format d'affichage de la
+ * donnée.
+ * \param table : table concernée.
+ * \param name : nom de la donnée primaire dans la table.
+ * \return Chaine de caractères, ou chaine vide en cas d'échec.
+ */
+
+QString QamModbusMap::remoteValue(PrimaryTable table, const QString& name )
+{
+	if ( m_mode != ClientMode )		return QString("") ;
+
+	// init. m_table, m_name, m_item
+	if ( !checkPrimaryName(table, name ) ) {
+		modbusInfo( "can't find entry in table" ) ;
+		return QString("") ;
+	}
+
+	if ( !m_isServerAvailable )	{
 		modbusInfo("no available connection !" ) ;
 		emit valueChanged((int)m_table, m_name ) ;
 		return QString("") ;
@@ -1153,10 +1547,7 @@ QString QamModbusMap::remoteValue(PrimaryTable table, const QString& name )
 
 	m_addr = dta.address() ;
 
-	if (( dta.display() == "Float" )||( dta.display() == "Long" ))	m_number = 2 ;
-	else if ( dta.display() == "Str8" )		m_number = 4 ;
-	else if ( dta.display() == "Str16" )	m_number = 8 ;
-	else m_number = 1 ;
+	m_number = qMax( 1, dta.wordsCount() ) ;	// mots d'une donnée composée
 
 	buildAndSendReadFrame() ;
 
@@ -1167,37 +1558,484 @@ QString QamModbusMap::remoteValue(PrimaryTable table, const QString& name )
 
 void QamModbusMap::buildAndSendReadFrame()
 {
-	m_mbapTi++ ;
-	m_mbapLen = 6 ;
-	QByteArray	frame ;
-	frame.append( ( m_mbapTi >> 8 ) & 0xFF ) ;
-	frame.append( m_mbapTi & 0xFF ) ;
-	frame.append( ( m_mbapPi >> 8 ) & 0xFF ) ;
-	frame.append( m_mbapPi & 0xFF ) ;
-	frame.append( ( m_mbapLen >> 8 ) & 0xFF ) ;
-	frame.append( m_mbapLen & 0xFF ) ;
-	frame.append( m_mbapUi ) ;
-	frame.append( m_funct ) ;
-	frame.append( ( m_addr >> 8 ) & 0xFF ) ;
-	frame.append( m_addr & 0xFF ) ;
-	frame.append( ( m_number >> 8 ) & 0xFF ) ;
-	frame.append( m_number & 0xFF ) ;
-
-	if ( m_verbose ) {
-		QString s ;
-		for ( int i = 7 ; i < frame.count() ; ++i ) {
-			s += QString("%1").arg( quint8( frame.at(i) ), 2, 16, QLatin1Char('0') ).toUpper() ;
-			s += " " ;
-		}
-		modbusInfo( "send " + s + " ( R: " + m_name + " )" ) ;
+	m_syncTi = nextTransactionId() ;
+	QByteArray	frame = buildFrame(m_syncTi, m_funct, m_addr, m_number, 0, QByteArray() ) ;
+
+	if ( isTraced() ) {
+		modbusInfo( "send " + QamModbusPdu::hexDump( frame.constData() + 7, frame.count() - 7 ) + " ( R: " + m_name + " )" ) ;
 	}
 
-	QEventLoop waitLoop ;
-	connect(this, SIGNAL( responseDone() ), &waitLoop, SLOT( quit() ) ) ;
+	waitResponse( frame ) ;
+}
+
+// ---------------------------------------------------------------------------
+// dialogue réseau mode client asynchrone (new v2.7)
+// ---------------------------------------------------------------------------
+// les requêtes sont émises sans attente, dans la limite de maxInFlight()
+// requêtes sans réponse (les suivantes sont mises en file d'attente) ; la
+// réponse est associée à sa requête par le Transaction Identifier MBAP
+
+/*!
+ * Lecture asynchrone d'une donnée sur le serveur (mode client). La requête est
+ * émise immédiatement si la fenêtre d'émission le permet, sinon dès qu'une
+ * requête précédente est terminée. A réception de la réponse, la cartographie
+ * locale est mise à jour (signal valueChanged()), puis @a callback est invoquée
+ * et le signal remoteDone() est émis.
+ * \param table : table concernée.
+ * \param name : nom de la donnée primaire / secondaire / composée dans la table.
+ * \param callback : fonction de rappel (facultative).
+ * \param timeout : délai de réponse (ms) au-delà duquel la requête échoue.
+ * \return Identifiant de la requête, ou -1 en cas d'échec immédiat.
+ */
+
+int QamModbusMap::readRemoteAsync(PrimaryTable table, const QString& name, Callback callback, int timeout )
+{
+	QString	primary ;
+	int		item ;
+
+	if ( m_mode != ClientMode )	return -1 ;
+
+	if ( !resolveName(table, name, primary, item ) ) {
+		modbusInfo( "can't find entry in table" ) ;
+		return -1 ;
+	}
+	if ( !m_isServerAvailable )	{
+		modbusInfo("no available connection !" ) ;
+		return -1 ;
+	}
+
+	QamModbusData&	dta = data(table, primary ) ;
+
+	Transaction	t ;
+	if ( table == Coil )					t.funct = 1 ;
+	else if ( table == DiscretInput )		t.funct = 2 ;
+	else if ( table == InputRegister )		t.funct = 4 ;
+	else t.funct = 3 ;
+	t.table = table ;
+	t.name = name ;
+	t.addr = dta.address() ;
+	t.number = qMax( 1, dta.wordsCount() ) ;	// mots d'une donnée composée
+	t.value = 0 ;
+	t.item = 0 ;
+	t.itemValue = 0 ;
+	t.timeout = timeout ;
+	t.callback = callback ;
+	t.group = -1 ;
+
+	return submit( t ) ;
+}
+
+/*!
+ * Ecriture asynchrone d'une donnée sur le serveur (mode client), suivant les
+ * mêmes règles que readRemoteAsync(). L'écriture d'une donnée secondaire est
+ * précédée de la lecture de sa donnée primaire.
+ * \param table : table concernée (Coil ou HoldingRegister).
+ * \param name : nom de la donnée dans la table.
+ * \param value : valeur exprimée au format d'affichage de la donnée.
+ * \param callback : fonction de rappel (facultative).
+ * \param timeout : délai de réponse (ms) au-delà duquel la requête échoue.
+ * \return Identifiant de la requête, ou -1 en cas d'échec immédiat.
+ */
+
+int QamModbusMap::writeRemoteAsync(PrimaryTable table, const QString& name, const QString& value, Callback callback, int timeout )
+{
+	QString	primary ;
+	int		item ;
+
+	if ( m_mode != ClientMode )	return -1 ;
+
+	if ( !resolveName(table, name, primary, item ) ) {
+		modbusInfo( "can't find entry in table" ) ;
+		return -1 ;
+	}
+	if ( !m_isServerAvailable )	{
+		modbusInfo("no available connection !" ) ;
+		return -1 ;
+	}
+	if (( table != Coil )&&( table != HoldingRegister )) {
+		modbusInfo( "unable to write in a read-only table" ) ;
+		return -1 ;
+	}
+
+	QamModbusData&	dta = data(table, primary ) ;
+	quint16			compositeValue[8] ;
+	quint16			words ;
+
+	if ( !encodeFormattedValue(dta, item, value, compositeValue, words ) ) {
+		modbusInfo( "value incompatible with display format" ) ;
+		return -1 ;
+	}
+
+	Transaction	t ;
+	t.table = table ;
+	t.name = name ;
+	t.addr = dta.address() ;
+	t.number = words ;
+	t.value = compositeValue[0] ;
+	for ( int i = 0 ; i < words ; ++i ) {
+		t.data.append( ( compositeValue[i] >> 8 ) & 0xFF ) ;
+		t.data.append( compositeValue[i] & 0xFF ) ;
+	}
+	t.item = item ;
+	t.itemValue = compositeValue[0] ;
+	t.timeout = timeout ;
+	t.callback = callback ;
+	t.group = -1 ;
+
+	if ( item )	{					// lecture préalable de la donnée primaire
+		t.funct = 3 ;
+		t.number = 1 ;
+	}
+	else if ( table == Coil ) {
+		t.funct = 5 ;
+		t.value = ( t.value ? 0xFF00 : 0x0000 ) ;
+	}
+	else t.funct = ( words == 1 ? 6 : 16 ) ;
+
+	return submit( t ) ;
+}
+
+/*!
+ * Taille de la fenêtre d'émission des requêtes asynchrones.
+ * \param max : nombre maximal de requêtes émises sans réponse (1 au moins).
+ */
+
+void QamModbusMap::setMaxInFlight(int max )
+{
+	m_maxInFlight = qMax( 1, max ) ;
+	sendWaiting() ;
+}
+
+// [private] émission, ou mise en file d'attente si la fenêtre est pleine
+
+int QamModbusMap::submit(Transaction& t )
+{
+	t.ti = nextTransactionId() ;
+	t.id = t.ti ;
+
+	if ( m_inFlight.count() < m_maxInFlight )	send( t ) ;
+	else	m_waiting.enqueue( t ) ;
+
+	return t.id ;
+}
+
+// [private] émission effective et armement du délai de réponse
+
+void QamModbusMap::send(Transaction& t )
+{
+	QByteArray	frame = buildFrame(t.ti, t.funct, t.addr, t.number, t.value, t.data ) ;
+
+	if ( isTraced() ) {
+		modbusInfo( "send " + QamModbusPdu::hexDump( frame.constData() + 7, frame.count() - 7 ) + QString(" ( %1: ").arg( t.funct < 5 ? "R" : "W" ) + t.name + " )" ) ;
+	}
+
+	m_inFlight.insert( t.ti, t ) ;
+
+	quint16 ti = t.ti ;
+	QTimer::singleShot( t.timeout, this, [this, ti]() { expire( ti ) ; } ) ;
 
 	emit request( frame ) ;
+}
 
-	waitLoop.exec() ;
+// [private] émission des requêtes en attente tant que la fenêtre le permet
+
+void QamModbusMap::sendWaiting()
+{
+	while (( !m_waiting.isEmpty() )&&( m_inFlight.count() < m_maxInFlight )) {
+		Transaction t = m_waiting.dequeue() ;
+		send( t ) ;
+	}
+}
+
+// [private] délai de réponse dépassé
+
+void QamModbusMap::expire(quint16 ti )
+{
+	if ( !m_inFlight.contains( ti ) )	return ;		// réponse déjà reçue
+
+	Transaction t = m_inFlight.take( ti ) ;
+	modbusInfo( QString("response timeout (transaction %1)").arg( ti ) ) ;
+	finish(t, false ) ;
+}
+
+// [private] fin d'une transaction : enchaînement éventuel, rappel du
+// demandeur et émission des requêtes en attente
+
+void QamModbusMap::finish(Transaction& t, bool ok )
+{
+	// écriture d'une donnée secondaire : la donnée primaire vient d'être lue,
+	// la valeur de l'élément est appliquée avec son masque puis écrite
+	if (( ok )&&( t.item )) {
+		QamModbusData&	dta = data(t.table, t.addr ) ;
+		beginWrite() ;
+		dta.setValue(t.itemValue, t.item ) ;
+		endWrite() ;
+
+		t.item = 0 ;
+		t.funct = 6 ;
+		t.value = dta.value() ;
+		t.ti = nextTransactionId() ;
+		send( t ) ;
+		return ;
+	}
+
+	QString	value = (( ok )&&( !t.name.isEmpty() ) ? localValue(t.table, t.name ) : QString() ) ;
+
+	if ( t.callback )	t.callback( ok, value ) ;
+	emit remoteDone( t.id, ok ) ;
+
+	sendWaiting() ;
+}
+
+// ---------------------------------------------------------------------------
+// groupes de scrutation (new v2.8)
+// ---------------------------------------------------------------------------
+// un groupe réunit des données lues ensemble à chaque cycle ; les plages
+// d'adresses couvrantes sont calculées une fois pour toutes, chaque plage
+// étant lue par une seule requête FC3 / FC4
+
+/*!
+ * Déclaration d'un groupe de scrutation. Les données sont triées par adresse
+ * et regroupées en plages consécutives (125 mots ou 2000 bits au plus par
+ * plage) ; deux données séparées par au plus @a maxGap adresses non demandées,
+ * mais présentes dans la cartographie, sont lues par la même requête.
+ * \param table : table concernée.
+ * \param names : noms des données primaires / secondaires / composées.
+ * \param maxGap : nombre maximal d'adresses non demandées lues pour regrouper.
+ * \return Identifiant du groupe, ou -1 en cas d'échec (donnée inconnue).
+ */
+
+int QamModbusMap::addPollGroup(PrimaryTable table, const QStringList& names, int maxGap )
+{
+	int	maxCount = ( (( table == Coil )||( table == DiscretInput )) ? MODBUSMAP_MAX_BITS : MODBUSMAP_MAX_WORDS ) ;
+
+	PollGroup	g ;
+	g.table = table ;
+	g.pending = 0 ;
+	g.ok = true ;
+	g.timer = 0 ;
+
+	for ( int i = 0 ; i < names.count() ; ++i ) {
+		Handle h = handle(table, names.at(i) ) ;
+		if ( !h.isValid() ) {
+			modbusInfo( "poll group: can't use entry " + names.at(i) ) ;
+			return -1 ;
+		}
+		g.handles << h ;
+	}
+	if ( g.handles.isEmpty() )	return -1 ;
+
+	// plages occupées par les données, triées par adresse
+	QVector<PollRange>	spans ;
+	for ( int i = 0 ; i < g.handles.count() ; ++i ) {
+		PollRange r = { g.handles.at(i).address, (quint16)g.handles.at(i).words } ;
+		spans << r ;
+	}
+	std::sort( spans.begin(), spans.end(), [](const PollRange& a, const PollRange& b ) { return a.address < b.address ; } ) ;
+
+	// fusion des plages voisines
+	PollRange	cur = spans.at(0) ;
+	for ( int i = 1 ; i < spans.count() ; ++i ) {
+		const PollRange& next = spans.at(i) ;
+		int curEnd = cur.address + cur.number ;				// première adresse après la plage
+		int end = qMax( curEnd, next.address + next.number ) ;
+		bool merge = ( next.address <= curEnd + maxGap )&&( end - cur.address <= maxCount ) ;
+		// les mots intermédiaires doivent exister (sinon exception du serveur)
+		if (( merge )&&( next.address > curEnd ))	merge = isRangeAvailable(table, curEnd, next.address - 1 ) ;
+		if ( merge )	cur.number = end - cur.address ;
+		else {
+			g.ranges << cur ;
+			cur = next ;
+		}
+	}
+	g.ranges << cur ;
+
+	m_pollGroups << g ;
+	return m_pollGroups.count() - 1 ;
+}
+
+/*!
+ * Scrutation d'un groupe sur le serveur (mode client) : une requête asynchrone
+ * par plage. La cartographie locale est mise à jour à réception des réponses,
+ * les signaux valuesChanged() (si des valeurs ont changé) puis pollDone() sont
+ * émis après la dernière. Sans effet si la scrutation précédente du groupe
+ * n'est pas terminée.
+ * \param group : identifiant retourné par addPollGroup().
+ * \param timeout : délai de réponse (ms) de chaque requête.
+ * \return Nombre de requêtes émises, 0 si une scrutation est en cours, -1 en
+ * cas d'échec.
+ */
+
+int QamModbusMap::pollRemote(int group, int timeout )
+{
+	if (( group < 0 )||( group >= m_pollGroups.count() ))	return -1 ;
+	if (( m_mode != ClientMode )||( !m_isServerAvailable ))	return -1 ;
+
+	PollGroup&	g = m_pollGroups[ group ] ;
+	if ( g.pending )	return 0 ;
+
+	g.pending = g.ranges.count() ;
+	g.ok = true ;
+
+	for ( int i = 0 ; i < g.ranges.count() ; ++i ) {
+		Transaction	t ;
+		if ( g.table == Coil )					t.funct = 1 ;
+		else if ( g.table == DiscretInput )		t.funct = 2 ;
+		else if ( g.table == InputRegister )	t.funct = 4 ;
+		else t.funct = 3 ;
+		t.table = g.table ;
+		t.addr = g.ranges.at(i).address ;
+		t.number = g.ranges.at(i).number ;
+		t.value = 0 ;
+		t.item = 0 ;
+		t.itemValue = 0 ;
+		t.timeout = timeout ;
+		t.group = group ;
+		t.callback = [this, group](bool ok, const QString& ) {
+			PollGroup& pg = m_pollGroups[ group ] ;
+			pg.ok = pg.ok && ok ;
+			if ( --pg.pending )	return ;
+			if ( !pg.changed.isEmpty() ) {
+				QStringList names = pg.changed ;
+				pg.changed.clear() ;
+				emit valuesChanged((int)pg.table, names ) ;
+			}
+			emit pollDone(group, pg.ok ) ;
+		} ;
+		submit( t ) ;
+	}
+	return g.ranges.count() ;
+}
+
+/*!
+ * Valeurs numériques des données d'un groupe, dans l'ordre de déclaration,
+ * extraites de la cartographie locale (chaque plage est lue en un instantané
+ * cohérent) et converties suivant leur format : Bool, Int, Uint, Hex, Float
+ * ou Long ; une donnée secondaire est extraite de sa donnée primaire par son
+ * masque, les autres formats (bits, chaînes) donnent la valeur du premier mot.
+ * \param group : identifiant retourné par addPollGroup().
+ * \param values : tableau d'au moins autant de valeurs que de données.
+ * \return false si le groupe n'existe pas.
+ */
+
+bool QamModbusMap::pollValues(int group, float* values ) const
+{
+	if (( group < 0 )||( group >= m_pollGroups.count() ))	return false ;
+
+	const PollGroup&	g = m_pollGroups.at( group ) ;
+	quint16				words[ MODBUSMAP_MAX_BITS ] ;
+
+	for ( int r = 0 ; r < g.ranges.count() ; ++r ) {
+		const PollRange& range = g.ranges.at(r) ;
+		readWords(g.table, range.address, range.number, words ) ;
+
+		for ( int i = 0 ; i < g.handles.count() ; ++i ) {
+			const Handle& h = g.handles.at(i) ;
+			if (( h.address < range.address )||( h.address >= range.address + range.number ))	continue ;
+			values[i] = (float)decodeValue(h, words + ( h.address - range.address ) ) ;
+		}
+	}
+	return true ;
+}
+
+/*! Nombre de requêtes émises à chaque scrutation du groupe (-1 si inconnu). */
+
+int QamModbusMap::pollRanges(int group ) const
+{
+	if (( group < 0 )||( group >= m_pollGroups.count() ))	return -1 ;
+	return m_pollGroups.at( group ).ranges.count() ;
+}
+
+/*!
+ * Groupe de scrutation réunissant toutes les données primaires d'une table
+ * (new v2.9) ; avec setPollPeriod(), la table entière est actualisée en
+ * quelques requêtes de bloc.
+ * \param table : table concernée.
+ * \param maxGap : nombre maximal d'adresses non demandées lues pour regrouper.
+ * \return Identifiant du groupe, ou -1 si la table est vide.
+ */
+
+int QamModbusMap::addPollTable(PrimaryTable table, int maxGap )
+{
+	return addPollGroup(table, nameList( table ), maxGap ) ;
+}
+
+/*!
+ * Scrutation périodique d'un groupe (new v2.9) : pollRemote() est appelé
+ * toutes les @a period ms tant que la connexion est établie ; un cycle est
+ * sauté si le précédent n'est pas terminé.
+ * \param group : identifiant retourné par addPollGroup() ou addPollTable().
+ * \param period : période en ms, 0 pour arrêter la scrutation.
+ */
+
+void QamModbusMap::setPollPeriod(int group, int period )
+{
+	if (( group < 0 )||( group >= m_pollGroups.count() ))	return ;
+
+	PollGroup&	g = m_pollGroups[ group ] ;
+
+	if ( period <= 0 ) {
+		if ( g.timer )	g.timer->stop() ;
+		return ;
+	}
+	if ( g.timer == 0 ) {
+		g.timer = new QTimer( this ) ;
+		connect(g.timer, &QTimer::timeout, this, [this, group]() { pollRemote( group ) ; } ) ;
+	}
+	g.timer->start( period ) ;
+}
+
+/*! Période de scrutation d'un groupe en ms (0 si scrutation inactive). */
+
+int QamModbusMap::pollPeriod(int group ) const
+{
+	if (( group < 0 )||( group >= m_pollGroups.count() ))	return 0 ;
+
+	const QTimer* timer = m_pollGroups.at( group ).timer ;
+	return (( timer )&&( timer->isActive() ) ? timer->interval() : 0 ) ;
+}
+
+/*! Arrêt de la scrutation périodique de tous les groupes (new v2.9). */
+
+void QamModbusMap::stopPolling()
+{
+	for ( int i = 0 ; i < m_pollGroups.count() ; ++i )	setPollPeriod(i, 0 ) ;
+}
+
+// [private] conversion numérique des mots d'une donnée suivant son format
+
+double QamModbusMap::decodeValue(const Handle& handle, const quint16* words ) const
+{
+	quint16	w = words[0] ;
+
+	if ( handle.item ) {
+		quint16 mask = tableList( handle.table )->at( handle.index ).mask( handle.item ) ;
+		w = ( w & mask ) >> qCountTrailingZeroBits( mask ) ;
+	}
+
+	switch ( handle.format ) {
+	case QamModbusData::Bool :
+		return ( w ? 1 : 0 ) ;
+	case QamModbusData::Int :
+		return (qint16)w ;
+	case QamModbusData::Hex :
+	case QamModbusData::Uint :
+		return w ;
+	case QamModbusData::Bcd :
+		return ( ( w >> 12 ) & 0xF ) * 1000 + ( ( w >> 8 ) & 0xF ) * 100 + ( ( w >> 4 ) & 0xF ) * 10 + ( w & 0xF ) ;
+	case QamModbusData::Float : {
+		float v ;
+		std::memcpy( &v, words, sizeof(v) ) ;
+		return v ;
+	}
+	case QamModbusData::Long : {
+		qint32 v ;
+		std::memcpy( &v, words, sizeof(v) ) ;
+		return v ;
+	}
+	default :
+		return 0 ;
+	}
 }
 
 // ---------------------------------------------------------------------------
@@ -1207,6 +2045,10 @@ void QamModbusMap::buildAndSendReadFrame()
 /*!
  * Chargement d'une configuration par fichier CSV (encodage UTF-8). Les lignes du fichier
  * liées aux entrées de table sont analysées par la méthode addData().
+ * @n Si le cache est actif (cf. setMapCache()), la cartographie compilée rangée
+ * à côté du fichier CSV (cf. compiledMapName()) est utilisée quand elle correspond
+ * au contenu du fichier ; sinon, elle est produite après un chargement sans erreur
+ * (new v3.0).
  * \param filename : chemin d'accès au fichier.
  * \return false si le fichier ne peut être ouvert, true sinon.
  */
@@ -1218,62 +2060,281 @@ bool QamModbusMap::loadMap(const QString& filename )
 //	if ( file.open( QIODevice::ReadOnly | QIODevice::Text ) ) {
 //		QTextStream in( &file ) ;
 
-	if ( file.open( QIODevice::ReadOnly) ) {		// new 1.4
-		QByteArray fileBytes = file.readAll() ;
-		fileBytes.replace("\r\n", "\n" ) ;
-		fileBytes.replace("\r", "\n" ) ;
-		QTextStream in( fileBytes ) ;
+	if ( !file.open( QIODevice::ReadOnly) ) {		// new 1.4
+		addDataInfo(filename + " not found!") ;
+		return false ;
+	}
 
-//		in.setCodec( "UTF-8" ) ;					// new 1.4
-        in.setEncoding(QStringConverter::Utf8) ;    // new v2.1
+	QByteArray fileBytes = file.readAll() ;
+	file.close() ;
 
-		QString line = in.readLine() ;
-		int nline = 1 ;
+	// cartographie compilée à jour ? (new v3.0)
+	QByteArray	hash ;
+	QString		cache ;
+	if ( m_mapCache ) {
+		hash = QCryptographicHash::hash( fileBytes, QCryptographicHash::Sha1 ) ;
+		cache = compiledMapName( filename ) ;
+		if ( loadCompiledMap( cache, hash ) )	return true ;
+	}
 
-		addDataInfo("loading " + filename + "..." ) ;
+	fileBytes.replace("\r\n", "\n" ) ;
+	fileBytes.replace("\r", "\n" ) ;
+	QTextStream in( fileBytes ) ;
 
-		while ( !line.isNull() ) {
+//	in.setCodec( "UTF-8" ) ;					// new 1.4
+	in.setEncoding(QStringConverter::Utf8) ;    // new v2.1
 
-			if (( line.isEmpty() )||( line.startsWith("#") )) {
-				line = in.readLine() ;
-				nline++ ;
-				continue;
-			}
+	QString line = in.readLine() ;
+	int nline = 1 ;
+	int errors = 0 ;
 
-			QStringList	parse = line.split(";") ;
+	m_mapHost.clear() ;
 
-			if ( parse.size() == 2 ) {
-				if ( parse[0] == "HOST" ) {
-					if ( m_mode == ClientMode )	m_host = parse[1].trimmed() ;
-				}
-				else if ( parse[0] == "PORT" ) {
-					m_port = parse[1].trimmed().toUShort() ;
-				}
-				else if ( parse[0] == "INFO" ) {
-					m_desc = parse[1].trimmed() ;
-				}
-				else {
-					addDataInfo("unrecognized line", nline ) ;
-				}
+	addDataInfo("loading " + filename + "..." ) ;
+
+	while ( !line.isNull() ) {
+
+		if (( line.isEmpty() )||( line.startsWith("#") )) {
+			line = in.readLine() ;
+			nline++ ;
+			continue;
+		}
+
+		QStringList	parse = line.split(";") ;
+
+		if ( parse.size() == 2 ) {
+			if ( parse[0] == "HOST" ) {
+				m_mapHost = parse[1].trimmed() ;
+				if ( m_mode == ClientMode )	m_host = m_mapHost ;
 			}
-			else if ( parse.size() == MODBUSMAP_ENTRY_SIZE ) {
-				for ( int i = 0 ; i < MODBUSMAP_ENTRY_SIZE ; ++i ) {
-					parse[i] = parse[i].trimmed() ;
-				}
-				addData( parse, nline ) ;
+			else if ( parse[0] == "PORT" ) {
+				m_port = parse[1].trimmed().toUShort() ;
+			}
+			else if ( parse[0] == "INFO" ) {
+				m_desc = parse[1].trimmed() ;
 			}
 			else {
-				addDataInfo("invalid number of fields", nline ) ;
+				addDataInfo("unrecognized line", nline ) ;
+				errors++ ;
+			}
+		}
+		else if ( parse.size() == MODBUSMAP_ENTRY_SIZE ) {
+			for ( int i = 0 ; i < MODBUSMAP_ENTRY_SIZE ; ++i ) {
+				parse[i] = parse[i].trimmed() ;
 			}
+			if ( !addData( parse, nline ) )	errors++ ;
+		}
+		else {
+			addDataInfo("invalid number of fields", nline ) ;
+			errors++ ;
+		}
 
-			line = in.readLine() ;
-			nline++ ;
+		line = in.readLine() ;
+		nline++ ;
+	}
+
+	// un fichier erroné n'est pas compilé : ses erreurs restent signalées
+	if (( m_mapCache )&&( errors == 0 ))	saveCompiledMap( cache, hash ) ;
+
+	return true ;
+}
+
+/*!
+ * Nom de la cartographie compilée associée à un fichier CSV : même chemin,
+ * extension MODBUSMAP_CACHE_SUFFIX (new v3.0).
+ */
+
+QString QamModbusMap::compiledMapName(const QString& filename )
+{
+	QFileInfo	info( filename ) ;
+	return info.path() + "/" + info.completeBaseName() + "." + MODBUSMAP_CACHE_SUFFIX ;
+}
+
+// ---------------------------------------------------------------------------
+// cartographie compilée (new v3.0)
+// ---------------------------------------------------------------------------
+// image binaire projetable en mémoire (QFile::map()) : entête, entrées de
+// taille fixe dans l'ordre de création des données (addBitData() puis
+// addWordData()), table de chaînes UTF-8 terminées par '\0' ; les entiers
+// sont rangés dans l'ordre natif de la machine, un fichier produit sur une
+// machine d'ordre différent est simplement ignoré
+// l'image remplace l'analyse du fichier CSV (découpage, contrôles de
+// addData()) mais pas le modèle de données : les entrées sont rejouées par
+// addBitData() / addWordData(), qui créent les QamModbusData et les index
+// par adresse et par nom consultés par handle(), exists() et data()
+
+#define	QMB_MAGIC		0x31424D51		// "QMB1"
+#define	QMB_VERSION		2		// v2 : champ HOST brut (new v3.6)
+
+struct QmbHeader {
+	quint32		magic ;
+	quint32		version ;
+	quint8		hash[20] ;		// SHA-1 du fichier CSV source
+	quint32		entryCount ;
+	quint32		entryOffset ;
+	quint32		stringOffset ;
+	quint32		stringSize ;
+	quint32		host ;			// chaînes : offsets dans la table (host : champ HOST du CSV, "" si absent)
+	quint32		desc ;
+	quint16		port ;
+	quint16		reserved ;
+} ;
+
+struct QmbEntry {
+	quint8		table ;
+	quint8		reserved ;
+	quint16		address ;
+	quint16		mask ;
+	quint16		value ;
+	quint32		name ;
+	quint32		comment ;
+	quint32		display ;
+} ;
+
+// [private] chargement d'une cartographie compilée ; toute l'image est
+// contrôlée avant la création de la première donnée
+
+bool QamModbusMap::loadCompiledMap(const QString& filename, const QByteArray& hash )
+{
+	QFile	file( filename ) ;
+	if ( !file.open( QIODevice::ReadOnly ) )	return false ;
+
+	qint64	size = file.size() ;
+	if ( size < (qint64)sizeof(QmbHeader) )	return false ;
+
+	const uchar* image = file.map( 0, size ) ;
+	if ( image == nullptr )	return false ;
+
+	QmbHeader	header ;
+	std::memcpy( &header, image, sizeof(header) ) ;
+
+	bool ok = ( header.magic == QMB_MAGIC )
+			&&( header.version == QMB_VERSION )
+			&&( hash.size() == (int)sizeof(header.hash) )
+			&&( std::memcmp( header.hash, hash.constData(), sizeof(header.hash) ) == 0 )
+			&&( header.entryOffset >= sizeof(QmbHeader) )
+			&&( (qint64)header.entryOffset + (qint64)header.entryCount * sizeof(QmbEntry) <= header.stringOffset )
+			&&( (qint64)header.stringOffset + header.stringSize <= size )
+			&&( header.stringSize > 0 )
+			&&( image[ header.stringOffset + header.stringSize - 1 ] == 0 )
+			&&( header.host < header.stringSize )&&( header.desc < header.stringSize ) ;
+
+	const char*		strings = (const char*)( image + header.stringOffset ) ;
+	const uchar*	entries = image + header.entryOffset ;
+
+	for ( quint32 i = 0 ; ( ok )&&( i < header.entryCount ) ; ++i ) {
+		QmbEntry	e ;
+		std::memcpy( &e, entries + i * sizeof(QmbEntry), sizeof(e) ) ;
+		ok = ( e.table <= HoldingRegister )
+			&&( e.name < header.stringSize )&&( e.comment < header.stringSize )&&( e.display < header.stringSize ) ;
+	}
+
+	if ( !ok ) {
+		file.unmap( (uchar*)image ) ;
+		return false ;
+	}
+
+	addDataInfo("loading " + filename + "..." ) ;
+
+	// chaînes partagées (formats, commentaires vides...) converties une
+	// seule fois, les copies suivantes partageant leurs données
+	QHash<quint32,QString>	texts ;
+	auto text = [&texts, strings](quint32 offset ) -> QString {
+		QHash<quint32,QString>::iterator it = texts.find( offset ) ;
+		if ( it == texts.end() )	it = texts.insert( offset, QString::fromUtf8( strings + offset ) ) ;
+		return it.value() ;
+	} ;
+
+	m_mapHost = text( header.host ) ;
+	if (( m_mode == ClientMode )&&( !m_mapHost.isEmpty() ))	m_host = m_mapHost ;
+	m_port = header.port ;
+	m_desc = text( header.desc ) ;
+
+	for ( quint32 i = 0 ; i < header.entryCount ; ++i ) {
+		QmbEntry	e ;
+		std::memcpy( &e, entries + i * sizeof(QmbEntry), sizeof(e) ) ;
+
+		PrimaryTable	table = (PrimaryTable)e.table ;
+
+		if (( table == Coil )||( table == DiscretInput ))	addBitData(table, e.address, QString::fromUtf8( strings + e.name ), text( e.comment ), e.value ) ;
+		else	addWordData(table, e.address, e.mask, QString::fromUtf8( strings + e.name ), text( e.comment ), text( e.display ), e.value ) ;
+	}
+
+	file.unmap( (uchar*)image ) ;
+	return true ;
+}
+
+// [private] production de la cartographie compilée à partir des tables :
+// données primaires dans l'ordre des tables, chacune suivie de ses données
+// secondaires (ordre de recréation compatible avec addWordData())
+
+bool QamModbusMap::saveCompiledMap(const QString& filename, const QByteArray& hash )
+{
+	QByteArray				strings ;
+	QHash<QString,quint32>	offsets ;
+
+	// chaîne -> offset dans la table (chaînes identiques partagées)
+	auto string = [&strings, &offsets](const QString& str ) -> quint32 {
+		QHash<QString,quint32>::const_iterator it = offsets.constFind( str ) ;
+		if ( it != offsets.constEnd() )	return it.value() ;
+		quint32 offset = strings.size() ;
+		strings += str.toUtf8() ;
+		strings += '\0' ;
+		offsets.insert( str, offset ) ;
+		return offset ;
+	} ;
+
+	QmbHeader	header ;
+	std::memset( &header, 0, sizeof(header) ) ;
+	header.magic = QMB_MAGIC ;
+	header.version = QMB_VERSION ;
+	std::memcpy( header.hash, hash.constData(), qMin<int>( hash.size(), sizeof(header.hash) ) ) ;
+	header.host = string( m_mapHost ) ;
+	header.desc = string( m_desc ) ;
+	header.port = m_port ;
+
+	QVector<QmbEntry>	entries ;
+
+	for ( int t = Coil ; t <= HoldingRegister ; ++t ) {
+		const QList<QamModbusData>* list = tableList( (PrimaryTable)t ) ;
+		for ( int i = 0 ; i < list->size() ; ++i ) {
+			const QamModbusData& d = list->at(i) ;
+			for ( int item = 0 ; item < d.itemsNumber() ; ++item ) {
+				QmbEntry e ;
+				std::memset( &e, 0, sizeof(e) ) ;
+				e.table = t ;
+				e.address = d.address() ;
+				e.mask = d.mask( item ) ;
+				e.value = d.value( item ) ;
+				e.name = string( d.name( item ) ) ;
+				e.comment = string( d.comment( item ) ) ;
+				e.display = string( d.display( item ) ) ;
+				entries << e ;
+			}
 		}
-		file.close() ;
-		return true ;
 	}
-	addDataInfo(filename + " not found!") ;
-	return false ;
+
+	header.entryCount = entries.size() ;
+	header.entryOffset = sizeof(QmbHeader) ;
+	header.stringOffset = header.entryOffset + entries.size() * sizeof(QmbEntry) ;
+	header.stringSize = strings.size() ;
+
+	// pas de cache, sans message, pour les ressources Qt et les répertoires
+	// protégés en écriture (new v3.6)
+	if (( filename.startsWith(':') )||( !QFileInfo( QFileInfo( filename ).path() ).isWritable() ))	return false ;
+
+	// écriture dans un fichier temporaire renommé en fin d'écriture : un
+	// lecteur concurrent ne voit jamais d'image partielle
+	QSaveFile	file( filename ) ;
+	if ( !file.open( QIODevice::WriteOnly ) ) {
+		addDataInfo("can't write " + filename ) ;
+		return false ;
+	}
+	file.write( (const char*)&header, sizeof(header) ) ;
+	file.write( (const char*)entries.constData(), entries.size() * sizeof(QmbEntry) ) ;
+	file.write( strings ) ;
+
+	return file.commit() ;
 }
 
 /*!
@@ -1500,12 +2561,15 @@ bool QamModbusMap::addBitData(PrimaryTable table, quint16 address, const QString
 {
 	if (( table != DiscretInput )&&( table != Coil ))	return false ;
 
-	QamModbusData*	data = new QamModbusData(name, address, false, value, this ) ;
-	data->setComment( comment ) ;
-	data->setDisplay("Bool" ) ;
+	QamModbusData	data(name, address, false, value ) ;		// copié dans la table
+	data.setComment( comment ) ;
+	data.setDisplay("Bool" ) ;
 
-	if ( table == Coil )	m_coils->append( *data ) ;
-	else					m_discreteInputs->append( *data ) ;
+	QList<QamModbusData>*	list = tableList( table ) ;
+	list->append( data ) ;
+	indexData(table, list->size() - 1, address ) ;
+	indexName(table, list->size() - 1, 0, name ) ;
+	list->last().bind( &m_store[ table ] ) ;
 
 	return true ;
 }
@@ -1521,30 +2585,85 @@ bool QamModbusMap::addWordData(PrimaryTable table, quint16 address, quint16 mask
 	// nouvelle entrée dans la table ?
 
 	if (( mask == 0xFFFF )||( mask == 0x0000 )) {
-		QamModbusData* data = new QamModbusData(name, address, true, value, this ) ;
-		data->setMask( mask ) ;
-		data->setComment( comment ) ;
-		data->setDisplay( display ) ;
-		list->append( *data ) ;
+		QamModbusData data(name, address, true, value ) ;		// copié dans la table
+		data.setMask( mask ) ;
+		data.setComment( comment ) ;
+		data.setDisplay( display ) ;
+		list->append( data ) ;
+		indexData(table, list->size() - 1, address ) ;
+		indexName(table, list->size() - 1, 0, name ) ;
+		list->last().bind( &m_store[ table ] ) ;
 		return true ;
 	}
 
 	// sinon, nouvel item pour entrée existante
 
 	else {
-		for ( int i = 0 ; i < list->size() ; ++i ) {
+		int i = indexOf(table, address ) ;
+		if ( i >= 0 ) {
 			QamModbusData& md = list->operator [](i) ;
-			if ( md.address() == address ) {
-				int itemId = md.addItem(name, mask, value ) ;
-				md.setComment(comment, itemId ) ;
-				md.setDisplay(display, itemId ) ;
-				return true ;
-			}
+			int itemId = md.addItem(name, mask, value ) ;
+			md.setComment(comment, itemId ) ;
+			md.setDisplay(display, itemId ) ;
+			indexName(table, i, itemId, name ) ;
+			return true ;
 		}
 	}
 	return false ;
 }
 
+// [private] index adresse -> rang dans la table ; la première donnée
+// déclarée à une adresse reste la donnée de référence
+
+void QamModbusMap::indexData(PrimaryTable table, int index, quint16 address )
+{
+	QVector<qint32>&	idx = m_addrIndex[ table ] ;
+
+	if ( address >= idx.size() ) {
+		int size = idx.size() ;
+		idx.resize( address + 1 ) ;
+		for ( int i = size ; i < idx.size() ; ++i )	idx[i] = -1 ;
+		m_store[ table ].resize( address + 1 ) ;
+		for ( int i = size ; i < idx.size() ; ++i )	m_store[ table ][i] = 0 ;
+	}
+	if ( idx[ address ] < 0 )	idx[ address ] = index ;
+}
+
+// [private] index nom -> emplacement ; une donnée primaire est prioritaire
+// sur une donnée secondaire de même nom
+
+void QamModbusMap::indexName(PrimaryTable table, int index, int item, const QString& name )
+{
+	QHash<QString,Location>&	idx = m_nameIndex[ table ] ;
+	QHash<QString,Location>::iterator	it = idx.find( name ) ;
+
+	Location loc ;
+	loc.index = index ;
+	loc.item = item ;
+
+	if ( it == idx.end() )				idx.insert( name, loc ) ;
+	else if (( it->item )&&( !item ))	*it = loc ;
+}
+
+// [private] recherche par nom, nullptr si non trouvé
+
+const QamModbusMap::Location* QamModbusMap::location(PrimaryTable table, const QString& name ) const
+{
+	const QHash<QString,Location>&	idx = m_nameIndex[ table ] ;
+	QHash<QString,Location>::const_iterator	it = idx.constFind( name ) ;
+
+	return ( it == idx.constEnd() ? nullptr : &it.value() ) ;
+}
+
+// [private] recherche par adresse, -1 si adresse libre
+
+int QamModbusMap::indexOf(PrimaryTable table, quint16 address ) const
+{
+	const QVector<qint32>&	idx = m_addrIndex[ table ] ;
+
+	return ( address < idx.size() ? idx.at( address ) : -1 ) ;
+}
+
 // ---------------------------------------------------------------------------
 // Remontée d'informations
 // ---------------------------------------------------------------------------
@@ -1570,6 +2689,22 @@ void QamModbusMap::modbusInfo(const QString& message )
 	emit info("modbus", message ) ;
 }
 
+// relais message Modbus littéral, converti seulement si info() est connecté
+// [private] (new v3.3)
+
+void QamModbusMap::modbusInfo(const char* message )
+{
+	if ( isInfoListened() )	emit info("modbus", QString::fromUtf8( message ) ) ;
+}
+
+// vrai si le signal info() est connecté [private] (new v3.3)
+
+bool QamModbusMap::isInfoListened() const
+{
+	static const QMetaMethod	signal = QMetaMethod::fromSignal( &QamModbusMap::info ) ;
+	return isSignalConnected( signal ) ;
+}
+
 // relais message produit par addData() [private]
 
 void QamModbusMap::addDataInfo(const QString& message, int line )
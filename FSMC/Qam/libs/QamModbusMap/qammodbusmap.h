@@ -126,25 +126,47 @@ chacune un certain nombre de bits de leur donnée primaire.
 40208-40209 (formats 32 bits).
 @n La donnée composée nommée "Hello" occupe en réalité les emplacements 40701, 40702, 40703 et
 40704 de la table Holding Registers.
+@n Au premier chargement sans erreur, loadMap() produit à côté du fichier CSV une
+cartographie compilée (même nom, extension .qmb) : image binaire des tables, de leurs
+chaînes et des valeurs initiales, validée par l'empreinte SHA-1 du fichier CSV. Les
+chargements suivants l'utilisent tant que le fichier CSV n'est pas modifié (cf. setMapCache()).
+Seule l'analyse du fichier CSV est évitée : les données (QamModbusData) et les index de
+recherche sont reconstruits à partir de l'image comme lors d'un chargement CSV.
+Aucune cartographie compilée n'est produite pour un fichier de ressources Qt (chemin
+commençant par ':') ou rangé dans un répertoire protégé en écriture.
  */
 
 //#include "qamabstractserver.h"
 #include "../QamSockets/qamabstractserver.h"
 
 #include "qammodbusdata.h"
+#include "qammodbuspdu.h"
 #include <QMutex>
+#include <QAtomicInteger>
 #include <QEventLoop>
+#include <QTimer>
+#include <QQueue>
 #include <QStringList>
 #include <QList>
+#include <QVector>
+#include <QHash>
 #include <QFile>
 #include <QFileInfo>
 #include <QTextStream>
+#include <functional>
 
 //#define MODBUSMAP_VERSION_MAJOR	1
 //#define MODBUSMAP_VERSION_MINOR	4
 #include "_ABOUT"
 
 #define	MODBUSMAP_ENTRY_SIZE	7
+#define	MODBUSMAP_MAX_BATCH		32		// setLocalValues() : nombre maximal de données
+#define	MODBUSMAP_TIMEOUT		1000	// délai de réponse du serveur (ms)
+#define	MODBUSMAP_MAX_INFLIGHT	8		// requêtes asynchrones simultanées
+#define	MODBUSMAP_POLL_GAP		8		// addPollGroup() : mots non demandés lus pour regrouper
+#define	MODBUSMAP_MAX_WORDS		125		// lecture FC3 / FC4 : nombre maximal de mots
+#define	MODBUSMAP_MAX_BITS		2000	// lecture FC1 / FC2 : nombre maximal de bits
+#define	MODBUSMAP_CACHE_SUFFIX	"qmb"	// cartographie compilée, à côté du fichier CSV
 
 class QamModbusMap : public QamAbstractServer
 {
@@ -171,16 +193,42 @@ class QamModbusMap : public QamAbstractServer
 		HoldingRegister = 4
 	} PrimaryTable ;
 
+	/*! Référence pré-résolue sur une donnée primaire, secondaire ou composée
+	 * (cf. handle()). Elle reste valide tant que la cartographie n'est pas
+	 * complétée par addData() ou loadMap().
+	 */
+	struct Handle {																// new v2.2
+		PrimaryTable			table ;
+		int						index ;		// rang de la donnée primaire dans sa table
+		quint16					address ;
+		int						item ;		// 0 : donnée primaire ou composée, sinon secondaire
+		int						words ;		// nombre de mots (1, 2, 4 ou 8)
+		QamModbusData::Display	format ;	// format résolu de la donnée (v3.6)
+		QString					name ;		// nom de la donnée primaire (signal valueChanged)
+
+		Handle() : table( HoldingRegister ), index( -1 ), address( 0 ), item( 0 ), words( 0 ), format( QamModbusData::Hex ) {}
+		/*! Vrai si la référence a été résolue avec succès. */
+		inline bool isValid() const { return index >= 0 ; }
+		/*! Vrai si la donnée a une valeur numérique (formats autres que Ascii,
+		 * Str8 et Str16, new v3.6).
+		 */
+		inline bool isNumeric() const {
+			return ( index >= 0 )&&( format != QamModbusData::Ascii )&&( format != QamModbusData::Str8 )&&( format != QamModbusData::Str16 ) ;
+		}
+	} ;
+
 	explicit QamModbusMap(Mode mode = ServerMode, QObject* parent = 0 ) ;
 
 	static QString version() ;
 	static QString tableAsString(PrimaryTable table ) ;
 
 	friend class QamModbusMapViewer ;	// accès aux méthodes data()
+	friend class QamModbusPushServer ;	// accès aux tables (instantanés)		// new v3.2
 
 	/*! En mode 'verbose' (actif par défaut), le PDU des trames Modbus échangées
 	 * est remonté par le signal info() sous forme d'un préfixe 'recv' ou 'send'
-	 * suivi d'une suite d'octets en hexadécimal.
+	 * suivi d'une suite d'octets en hexadécimal. La mise en forme n'a lieu
+	 * que si le signal info() est connecté (new v3.3).
 	 */
 	inline void setVerbose(bool verbose = true ) { m_verbose = verbose ; }
 
@@ -206,9 +254,10 @@ class QamModbusMap : public QamAbstractServer
   public:
 //	virtual QByteArray responseToRequest(QByteArray& request ) ;
 	virtual QByteArray responseToClientRequest(QByteArray& request ) ;
+	virtual int frameLength(const char* data, int size ) const ;				// new v2.6
   private:
 	bool isRangeAvailable(PrimaryTable table, quint16 addrBegin, quint16 addrEnd ) ;
-	QByteArray	exceptionResponse(QByteArray& request, quint8 exceptionCode, const QString& message ) ;
+	QByteArray	exceptionResponse(const QByteArray& request, quint8 exceptionCode, const char* message ) ;
 
 	// dialogue réseau mode client
 	// ---------------------------------------------------------------------------
@@ -219,6 +268,17 @@ class QamModbusMap : public QamAbstractServer
 
   private:
 	virtual void setServerAvailable(bool serverAvailable ) ;
+	bool applyResponse(const QByteArray& response, quint8 funct, quint16 addr, quint16 number, quint16 value, const QByteArray& data, QStringList* changed = 0 ) ;	// new v2.7
+	QByteArray buildFrame(quint16 ti, quint8 funct, quint16 addr, quint16 number, quint16 value, const QByteArray& data ) const ;	// new v2.7
+	quint16 nextTransactionId() ;												// new v2.7
+	void waitResponse(const QByteArray& frame ) ;								// new v2.7
+
+  public:
+	/*! Délai d'attente de la réponse du serveur pour remoteValue() et
+	 * setRemoteValue() (new v2.7).
+	 */
+	inline void setTimeout(int ms ) { m_timeout = ms ; }
+	inline int timeout() const { return m_timeout ; }
 
 
 	// accesseurs tables/données/formats
@@ -232,11 +292,16 @@ class QamModbusMap : public QamAbstractServer
 	bool exists(PrimaryTable table, const QString& name ) ;
 	bool exists(PrimaryTable table, quint16 address ) ;
 
+	Handle handle(PrimaryTable table, const QString& name ) ;					// new v2.2
+
   private:
+	QList<QamModbusData>* tableList(PrimaryTable table ) const ;				// new v2.2
 	QamModbusData& data(PrimaryTable table, const QString& name ) ;
 	QamModbusData& data(PrimaryTable table, quint16 address ) ;
 	bool checkPrimaryName(PrimaryTable table, const QString& name ) ;
 	bool checkFormattedValue(const QamModbusData& data, const QString& value ) ;
+	bool resolveName(PrimaryTable table, const QString& name, QString& primary, int& item ) const ;	// new v2.5
+	bool encodeFormattedValue(const QamModbusData& data, int item, const QString& value, quint16* compositeValue, quint16& words ) const ;	// new v2.5
 
 	// modificateurs de données Modbus
 	// ---------------------------------------------------------------------------
@@ -246,8 +311,26 @@ class QamModbusMap : public QamAbstractServer
 	void setLocalValue(PrimaryTable table, const QString& name, const QString& value ) ;
 	void setRemoteValue(PrimaryTable table, const QString& name, const QString& value ) ;
 
+  public:
+	bool setLocalValue(const Handle& handle, float value ) ;					// new v2.2
+	bool setLocalValue(const Handle& handle, qint16 value ) ;					// new v2.2
+	bool setLocalValues(const Handle* handles, const float* values, int count ) ;	// new v2.2
+	bool setLocalWords(PrimaryTable table, const quint16* addresses, const quint16* values, int count ) ;	// new v3.6
+	bool setNumericValue(const Handle& handle, double value ) ;				// new v3.5
+	/*! Ecriture locale typée par référence (cf. setNumericValue()). */
+	template<typename T> inline bool setValueAs(const Handle& handle, T value ) { return setNumericValue( handle, static_cast<double>( value ) ) ; }
+
   private:
 	void buildAndSendWriteFrame() ;
+	bool encodeValue(const Handle& handle, double value, quint16* words ) const ;	// new v2.2
+	void writeWords(const Handle& handle, const quint16* words ) ;			// new v2.2
+	void emitValueChanged(const Handle& handle ) ;							// new v2.2
+
+	// cohérence de l'image des registres (seqlock)							// new v2.5
+	void beginWrite() ;
+	void endWrite() ;
+	void readWords(PrimaryTable table, quint16 address, int count, quint16* dest ) const ;
+	quint16* storeWords(PrimaryTable table ) ;									// new v3.6
 
 	// sélecteurs de données Modbus
 	// ---------------------------------------------------------------------------
@@ -256,10 +339,105 @@ class QamModbusMap : public QamAbstractServer
 	QString value(PrimaryTable table, const QString& name ) ;
 	QString localValue(PrimaryTable table, const QString& name ) ;
 	QString remoteValue(PrimaryTable table, const QString& name ) ;
+	double numericValue(const Handle& handle ) const ;							// new v3.5
+	/*! Lecture locale typée par référence (cf. numericValue()). */
+	template<typename T> inline T valueAs(const Handle& handle ) const { return static_cast<T>( numericValue( handle ) ) ; }
+	/*! Lecture locale typée par nom (résolution du nom à chaque appel). */
+	template<typename T> inline T valueAs(PrimaryTable table, const QString& name ) { return valueAs<T>( handle( table, name ) ) ; }
 
   private:
 	void buildAndSendReadFrame() ;
 
+	// dialogue réseau mode client asynchrone									// new v2.7
+	// ---------------------------------------------------------------------------
+
+  public:
+	/*! Fonction de rappel d'une requête asynchrone : succès de la transaction
+	 * et valeur mise en forme de la donnée dans la cartographie locale.
+	 */
+	typedef std::function<void(bool ok, const QString& value)>	Callback ;
+
+	int readRemoteAsync(PrimaryTable table, const QString& name, Callback callback = Callback(), int timeout = MODBUSMAP_TIMEOUT ) ;
+	int writeRemoteAsync(PrimaryTable table, const QString& name, const QString& value, Callback callback = Callback(), int timeout = MODBUSMAP_TIMEOUT ) ;
+	void setMaxInFlight(int max ) ;
+	/*! Nombre maximal de requêtes asynchrones émises sans réponse. */
+	inline int maxInFlight() const { return m_maxInFlight ; }
+	/*! Nombre de requêtes asynchrones émises ou en attente d'émission. */
+	inline int inFlight() const { return m_inFlight.count() + m_waiting.count() ; }
+
+  signals:
+	/*! Fin d'une requête asynchrone (réponse, exception, délai dépassé ou
+	 * perte de connexion).
+	 */
+	void remoteDone(int transaction, bool ok ) ;
+
+  private:
+	/* requête asynchrone */
+	struct Transaction {
+		int				id ;		// identifiant retourné au demandeur
+		quint16			ti ;		// Transaction Identifier MBAP
+		quint8			funct ;
+		PrimaryTable	table ;
+		QString			name ;		// nom demandé (valeur retournée)
+		quint16			addr ;
+		quint16			number ;
+		quint16			value ;		// FC5 / FC6
+		QByteArray		data ;		// FC16
+		int				item ;		// écriture d'une donnée secondaire : lecture préalable
+		quint16			itemValue ;
+		int				timeout ;
+		Callback		callback ;
+		int				group ;		// groupe de scrutation, -1 si aucun	// new v2.9
+	} ;
+
+	int submit(Transaction& t ) ;
+	void send(Transaction& t ) ;
+	void sendWaiting() ;
+	void expire(quint16 ti ) ;
+	void finish(Transaction& t, bool ok ) ;
+
+	// groupes de scrutation												// new v2.8
+	// ---------------------------------------------------------------------------
+
+  public:
+	int addPollGroup(PrimaryTable table, const QStringList& names, int maxGap = MODBUSMAP_POLL_GAP ) ;
+	int addPollTable(PrimaryTable table, int maxGap = MODBUSMAP_POLL_GAP ) ;		// new v2.9
+	int pollRemote(int group, int timeout = MODBUSMAP_TIMEOUT ) ;
+	bool pollValues(int group, float* values ) const ;
+	int pollRanges(int group ) const ;
+	void setPollPeriod(int group, int period ) ;								// new v2.9
+	int pollPeriod(int group ) const ;											// new v2.9
+	void stopPolling() ;														// new v2.9
+
+  signals:
+	/*! Fin de la scrutation d'un groupe (toutes les plages reçues, ou échec). */
+	void pollDone(int group, bool ok ) ;
+	/*! Données primaires d'une table dont la valeur a changé lors d'une
+	 * scrutation (un seul signal par cycle et par groupe, new v2.9) ; les
+	 * réponses aux requêtes de scrutation n'émettent pas valueChanged().
+	 */
+	void valuesChanged(int table, const QStringList& names ) ;
+
+  private:
+	/* plage de mots consécutifs lue par une seule requête */
+	struct PollRange {
+		quint16		address ;
+		quint16		number ;
+	} ;
+
+	/* groupe de scrutation */
+	struct PollGroup {
+		PrimaryTable		table ;
+		QVector<Handle>		handles ;		// dans l'ordre de déclaration
+		QVector<PollRange>	ranges ;		// plages couvrantes, adresses croissantes
+		int					pending ;		// requêtes sans réponse
+		bool				ok ;			// succès de la scrutation en cours
+		QStringList			changed ;		// données modifiées pendant le cycle	// new v2.9
+		QTimer*				timer ;			// scrutation périodique (0 si aucune)	// new v2.9
+	} ;
+
+	double decodeValue(const Handle& handle, const quint16* words ) const ;
+
 	// création de la cartographie locale
 	// ---------------------------------------------------------------------------
 
@@ -267,9 +445,28 @@ class QamModbusMap : public QamAbstractServer
 	bool loadMap(const QString& filename ) ;
 	bool addData(const QStringList& entry, int line = 0 ) ;
 
+	static QString compiledMapName(const QString& filename ) ;					// new v3.0
+	/*! Utilisation par loadMap() d'une cartographie compilée (active par
+	 * défaut, new v3.0).
+	 */
+	inline void setMapCache(bool enable = true ) { m_mapCache = enable ; }
+	inline bool isMapCacheEnabled() const { return m_mapCache ; }
+
   private:
+	/* emplacement d'une donnée dans sa table (index de recherche par nom) */
+	struct Location {															// new v2.3
+		int		index ;			// rang de la donnée primaire dans sa table
+		int		item ;			// 0 : donnée primaire, sinon secondaire
+	} ;
+
 	bool addBitData(PrimaryTable table, quint16 address, const QString& name, const QString& comment, quint16 value = 0 ) ;
 	bool addWordData(PrimaryTable table, quint16 address, quint16 mask, const QString& name, const QString& comment, const QString& display, quint16 value = 0 ) ;
+	void indexData(PrimaryTable table, int index, quint16 address ) ;			// new v2.3
+	void indexName(PrimaryTable table, int index, int item, const QString& name ) ;	// new v2.3
+	const Location* location(PrimaryTable table, const QString& name ) const ;	// new v2.3
+	int indexOf(PrimaryTable table, quint16 address ) const ;				// new v2.3
+	bool loadCompiledMap(const QString& filename, const QByteArray& hash ) ;	// new v3.0
+	bool saveCompiledMap(const QString& filename, const QByteArray& hash ) ;	// new v3.0
 
 	// remontée d'informations
 	// ---------------------------------------------------------------------------
@@ -287,6 +484,10 @@ class QamModbusMap : public QamAbstractServer
 	virtual void networkInfo(const QString& message ) ;
 	void configInfo(const QString& message ) ;
 	void modbusInfo(const QString& message ) ;
+	void modbusInfo(const char* message ) ;									// new v3.3
+	bool isInfoListened() const ;												// new v3.3
+	/* trames remontées par info() : mode 'verbose' et signal connecté */
+	inline bool isTraced() const { return m_verbose && isInfoListened() ; }	// new v3.3
 	void addDataInfo(const QString& message, int line = 0 ) ;
 
 
@@ -297,26 +498,38 @@ class QamModbusMap : public QamAbstractServer
 	bool		m_verbose ;
 	Mode		m_mode ;
 	QString		m_host ;
+	QString		m_mapHost ;		// champ HOST du fichier CSV, quel que soit le mode (new v3.6)
 	quint16		m_port ;
 	QString		m_desc ;
 	bool		m_isServerAvailable ;
 
 	QamModbusData*	m_nullData ;
+	bool			m_mapCache ;	// new v3.0
 
-	QMutex			m_mutex ;
+	QMutex			m_mutex ;		// sérialisation des écrivains
+	QAtomicInteger<quint32>	m_seq ;	// séquence d'écriture, impaire pendant une écriture	// new v2.5
 
 	QList<QamModbusData>*	m_coils ;
 	QList<QamModbusData>*	m_discreteInputs ;
 	QList<QamModbusData>*	m_inputRegisters ;
 	QList<QamModbusData>*	m_holdingRegisters ;
 
+	// index de recherche maintenus par addBitData() et addWordData()		// new v2.3
+	QVector<qint32>			m_addrIndex[5] ;	// adresse -> rang (-1 si libre), par table
+	QHash<QString,Location>	m_nameIndex[5] ;	// nom -> emplacement, par table
+
+	// valeurs des tables, rangées par adresse (les QamModbusData y sont liées)	// new v2.4
+	QVector<quint16>		m_store[5] ;
+
+	// état des requêtes du mode client (le mode serveur travaille sur la pile)
 	PrimaryTable	m_table ;
 	QString			m_name ;
 	int				m_item ;
 
 	quint16		m_mbapTi ;
+	quint16		m_syncTi ;			// requête synchrone attendue (new v3.6)
+	bool		m_syncPending ;
 	quint16		m_mbapPi ;
-	quint16		m_mbapLen ;
 	quint8		m_mbapUi ;
 
 	quint8		m_funct ;
@@ -325,6 +538,14 @@ class QamModbusMap : public QamAbstractServer
 	quint16		m_value ;
 	QByteArray	m_data ;
 	quint8		m_exception ;
+
+	// requêtes asynchrones														// new v2.7
+	QHash<quint16,Transaction>	m_inFlight ;	// émises, par Transaction Identifier
+	QQueue<Transaction>			m_waiting ;		// en attente d'une place dans la fenêtre
+	int							m_maxInFlight ;
+	int							m_timeout ;		// délai des requêtes synchrones (ms)
+
+	QVector<PollGroup>			m_pollGroups ;	// new v2.8
 } ;
 
 #endif // QAMMODBUSMAP_H
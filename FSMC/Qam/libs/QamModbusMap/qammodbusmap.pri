@@ -34,13 +34,18 @@ CPPHEADERS	+= $$PWD/QamModbusMap
 
 HEADERS	+= \
 	$$PWD/qammodbusdata.h \
+	$$PWD/qammodbusgateway.h \
 	$$PWD/qammodbusmap.h \
-	$$PWD/qammodbusmapviewer.h
+	$$PWD/qammodbusmapviewer.h \
+	$$PWD/qammodbuspdu.h \
+	$$PWD/qammodbuspush.h
 
 SOURCES += \
 	$$PWD/qammodbusdata.cpp \
+	$$PWD/qammodbusgateway.cpp \
 	$$PWD/qammodbusmap.cpp \
-	$$PWD/qammodbusmapviewer.cpp
+	$$PWD/qammodbusmapviewer.cpp \
+	$$PWD/qammodbuspush.cpp
 
 DISTFILES += \
 	$${CPPHEADERS} \
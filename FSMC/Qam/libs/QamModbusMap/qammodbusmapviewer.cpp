@@ -26,6 +26,7 @@
  */
 
 #include "qammodbusmapviewer.h"
+#include <QSet>
 
 /*! Constructeur. */
 
@@ -113,64 +114,81 @@ void QamModbusMapViewer::itemChanged(QStandardItem* item )
 
 void QamModbusMapViewer::updateModbusData(int table, const QString& name )
 {
-	QamModbusMap::PrimaryTable	tbl = (QamModbusMap::PrimaryTable)table ;
+	updateModbusDataList(table, QStringList( name ) ) ;
+}
+
+// demande d'actualisation d'une liste de données primaires d'une même
+// table [private slot] ; l'arbre de la table n'est parcouru qu'une fois
+// (new v2.9)
 
-	if ( !m_modbusMap->exists(tbl, name) )	return ;
+void QamModbusMapViewer::updateModbusDataList(int table, const QStringList& names )
+{
+	QamModbusMap::PrimaryTable	tbl = (QamModbusMap::PrimaryTable)table ;
 
 	int row = tableToRow( tbl ) ;							// indice table
 	if ( row >= m_model->rowCount() )	return ;
 
-	m_internalUpdate = true ;								// 'inhibe' slot itemChanged()
+	QSet<QString>	pending ;
+	for ( int i = 0 ; i < names.count() ; ++i ) {
+		if ( m_modbusMap->exists(tbl, names.at(i) ) )	pending.insert( names.at(i) ) ;
+	}
+	if ( pending.isEmpty() )	return ;
 
-	QStringList	list = m_modbusMap->itemList(tbl, name ) ;	// données secondaires ?
+	m_internalUpdate = true ;								// 'inhibe' slot itemChanged()
 
 	QStandardItem* item1 = m_model->item( row ) ;			// item table
 
-	QColor	color(255, 102, 0, 32 ) ;						// colorisation en mode client
-
 	for ( int i = 0 ; i < item1->rowCount() ; ++ i ) {
 
 		QStandardItem* item2 = item1->child(i) ;
 		if ( item2 == 0 )	continue ;
 
-		if ( item1->child(i, m_iName )->text() == name ) {
-			// màj donnée primaire
-			quint16 value   = m_modbusMap->data( tbl, name ).value() ;
-			item1->child(i, m_iHex )->setText( QString("%1").arg(value, 4, 16, QLatin1Char('0') ).toUpper() ) ;
-			if ( !item1->child(i, m_iDisplay )->text().isEmpty() ) {
-
-				item1->child(i, m_iValue )->setText( m_modbusMap->localValue( tbl, name ) ) ;
-
-				if ( m_modbusMap->mode() == QamModbusMap::ClientMode )	item1->child(i, m_iValue )->setBackground( QBrush( color ) ) ;
-			}
-			// màj données secondaires le cas échéant
-			if ( !list.isEmpty() )	for ( int j = 0 ; j < item2->rowCount() ; ++j ) {
-				if ( item2->child(j) == 0 )	continue ;
-				QString itemName = item2->child(j, m_iName )->text() ;
-				if ( !list.contains( itemName ) )	continue ;
-				quint16 value   = m_modbusMap->data( tbl, name ).value( itemName ) ;
-				item2->child(j, m_iHex )->setText( QString("%1").arg(value, 4, 16, QLatin1Char('0') ).toUpper() ) ;
-				item2->child(j, m_iValue )->setText( m_modbusMap->data( tbl, name ).valueAsString( itemName ) ) ;
-
-				if ( m_modbusMap->mode() == QamModbusMap::ClientMode )	item2->child(j, m_iValue )->setBackground( QBrush( color ) ) ;
-			}
-		}
+		QString name = item1->child(i, m_iName )->text() ;
+		if ( pending.contains( name ) )	updateRow(tbl, item1, i, name ) ;
 
 		// new 1.4 : les suites de données composées sont maintenant enfants de leur donnée primaire...
 		for ( int j = 0 ; j < item2->rowCount() ; ++j ) {
 			if ( item2->child(j) == 0 )	continue ;
-			if ( item2->child(j, m_iName )->text() == name ) {
-				quint16 value   = m_modbusMap->data( tbl, name ).value() ;
-				item2->child(j, m_iHex )->setText( QString("%1").arg(value, 4, 16, QLatin1Char('0') ).toUpper() ) ;
-				break ;
-			}
+			QString childName = item2->child(j, m_iName )->text() ;
+			if ( !pending.contains( childName ) )	continue ;
+			quint16 value   = m_modbusMap->data( tbl, childName ).value() ;
+			item2->child(j, m_iHex )->setText( QString("%1").arg(value, 4, 16, QLatin1Char('0') ).toUpper() ) ;
 		}
-		//
 	}
 
 	m_internalUpdate = false ;
 }
 
+// [private] màj de la ligne d'une donnée primaire et de ses données secondaires
+
+void QamModbusMapViewer::updateRow(QamModbusMap::PrimaryTable tbl, QStandardItem* item1, int i, const QString& name )
+{
+	QStandardItem*	item2 = item1->child(i) ;
+	QStringList		list = m_modbusMap->itemList(tbl, name ) ;	// données secondaires ?
+	QColor			color(255, 102, 0, 32 ) ;					// colorisation en mode client
+
+	// màj donnée primaire
+	quint16 value   = m_modbusMap->data( tbl, name ).value() ;
+	item1->child(i, m_iHex )->setText( QString("%1").arg(value, 4, 16, QLatin1Char('0') ).toUpper() ) ;
+	if ( !item1->child(i, m_iDisplay )->text().isEmpty() ) {
+
+		item1->child(i, m_iValue )->setText( m_modbusMap->localValue( tbl, name ) ) ;
+
+		if ( m_modbusMap->mode() == QamModbusMap::ClientMode )	item1->child(i, m_iValue )->setBackground( QBrush( color ) ) ;
+	}
+	// màj données secondaires le cas échéant
+	if ( !list.isEmpty() )	for ( int j = 0 ; j < item2->rowCount() ; ++j ) {
+		if ( item2->child(j) == 0 )	continue ;
+		QString itemName = item2->child(j, m_iName )->text() ;
+		if ( !list.contains( itemName ) )	continue ;
+		quint16 value   = m_modbusMap->data( tbl, name ).value( itemName ) ;
+		item2->child(j, m_iHex )->setText( QString("%1").arg(value, 4, 16, QLatin1Char('0') ).toUpper() ) ;
+		item2->child(j, m_iValue )->setText( m_modbusMap->data( tbl, name ).valueAsString( itemName ) ) ;
+
+		if ( m_modbusMap->mode() == QamModbusMap::ClientMode )	item2->child(j, m_iValue )->setBackground( QBrush( color ) ) ;
+	}
+}
+
 /*!
  * Accès à la table primaire de l'entrée en cours de sélection (surbrillance).
  * \return Numéro de table compatible avec QamModbusMap::PrimaryTable, ou -1 si aucune sélection valide.
@@ -258,6 +276,8 @@ void QamModbusMapViewer::setModbusMap(QamModbusMap* map )
 	// interception des changements de valeurs
 	connect( m_modbusMap, SIGNAL(valueChanged(int,QString)),
 			 this,		  SLOT(updateModbusData(int,QString)) ) ;
+	connect( m_modbusMap, SIGNAL(valuesChanged(int,QStringList)),
+			 this,		  SLOT(updateModbusDataList(int,QStringList)) ) ;	// new v2.9
 }
 
 // création/initialisation cartographie d'une table primaire [private]
@@ -69,11 +69,13 @@ class QamModbusMapViewer : public QTreeView
   private slots:
 	void itemChanged(QStandardItem* item ) ;
 	void updateModbusData(int table, const QString& name ) ;
+	void updateModbusDataList(int table, const QStringList& names ) ;	// new v2.9
 
   private:
 	QamModbusMap::PrimaryTable rowToTable( int row ) ;
 	int tableToRow(QamModbusMap::PrimaryTable table ) ;
 	void setModbusTable(QamModbusMap::PrimaryTable table, quint16 baseNumber, int treeRow, bool isWords ) ;
+	void updateRow(QamModbusMap::PrimaryTable tbl, QStandardItem* item1, int i, const QString& name ) ;	// new v2.9
 	QStandardItem* newItem(const QString& item, bool editable = false, QColor bkColor = Qt::white ) ;
 
   private:
@@ -0,0 +1,201 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   qammodbuspdu.h
+ *  description :   INTERFACE des classes QamModbusPdu et QamModbusFrame
+ *					Codage / décodage des trames Modbus/TCP sans allocation
+ *
+ *	project     :	Qam Modbus over TCP/IP
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2014-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "Qam Modbus over IP Project"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#ifndef QAMMODBUSPDU_H
+#define QAMMODBUSPDU_H
+
+/*!
+  @file
+  @brief Codage / décodage des trames Modbus/TCP sans allocation
+ */
+
+/*!
+ @class QamModbusPdu
+ @brief Accès big-endian aux champs d'une trame Modbus/TCP.
+
+Fonctions de lecture / écriture des champs 16 bits d'une trame MBAP + PDU,
+découpage d'un flux en trames et réponse d'exception (communs à
+QamModbusMap, QamModbusGateway et au canal de notification) et mise en forme
+hexadécimale du PDU pour le mode 'verbose'.
+ */
+
+/*!
+ @class QamModbusFrame
+ @brief Trame Modbus/TCP construite dans un tampon de taille fixe.
+
+Une trame MBAP + PDU ne dépasse pas 260 octets (entête de 7 octets, PDU de
+253 octets au plus) : la classe QamModbusFrame, destinée à être instanciée
+sur la pile, permet de construire une requête ou une réponse sans allocation
+dynamique. Seule la conversion finale en QByteArray (toByteArray()),
+imposée par l'interface de QamAbstractServer, alloue la trame émise.
+
+@code
+	QamModbusFrame	frame ;
+	frame.appendMbap( ti, 0, 0xFF ) ;
+	frame.append8( 3 ) ;			// Function Code
+	frame.append16( addr ) ;
+	frame.append16( number ) ;
+	frame.updateLength() ;
+	emit request( frame.toByteArray() ) ;
+@endcode
+ */
+
+#include <QByteArray>
+#include <QString>
+#include <QtEndian>
+#include <cstring>
+
+#define	MODBUSPDU_MBAP_SIZE		7		// TI, PI, Length, UI
+#define	MODBUSPDU_MAX_ADU		260		// MBAP + PDU de 253 octets
+
+class QamModbusPdu
+{
+  public:
+	/*! Lecture d'un champ 16 bits big-endian. */
+	static inline quint16 get16(const char* p ) { return qFromBigEndian<quint16>( p ) ; }
+	/*! Ecriture d'un champ 16 bits big-endian. */
+	static inline void put16(char* p, quint16 value ) { qToBigEndian<quint16>( value, p ) ; }
+
+	/*!
+	 * Longueur de la trame complète en tête d'un flux reçu, donnée par le
+	 * champ Length de l'entête MBAP (Unit Identifier + PDU, 254 octets au plus).
+	 * \param data : début des données reçues non encore traitées.
+	 * \param size : nombre d'octets disponibles.
+	 * \return Longueur de la trame, 0 si elle est incomplète, -1 si l'entête
+	 * MBAP est invalide.
+	 */
+	static inline int frameLength(const char* data, int size )
+	{
+		if ( size < MODBUSPDU_MBAP_SIZE )	return 0 ;		// entête MBAP incomplet
+
+		quint16	pi  = get16( data + 2 ) ;
+		quint16	len = get16( data + 4 ) ;
+
+		if (( pi != 0 )||( len < 2 )||( len > 254 ))	return -1 ;
+
+		if ( size < 6 + len )	return 0 ;
+		return 6 + len ;
+	}
+
+	static inline QByteArray exceptionResponse(const QByteArray& request, quint8 exceptionCode ) ;
+
+	/*!
+	 * Mise en forme hexadécimale (majuscules, octets séparés par une espace)
+	 * en une seule allocation.
+	 * \param data : premier octet.
+	 * \param size : nombre d'octets.
+	 */
+	static inline QString hexDump(const char* data, int size )
+	{
+		static const char	digits[] = "0123456789ABCDEF" ;
+
+		if ( size <= 0 )	return QString() ;
+
+		QString	s( size * 3, Qt::Uninitialized ) ;
+		QChar*	p = s.data() ;
+		for ( int i = 0 ; i < size ; ++i ) {
+			*p++ = QLatin1Char( digits[ ( (quint8)data[i] ) >> 4 ] ) ;
+			*p++ = QLatin1Char( digits[ ( (quint8)data[i] ) & 0x0F ] ) ;
+			*p++ = QLatin1Char(' ') ;
+		}
+		return s ;
+	}
+} ;
+
+class QamModbusFrame
+{
+  public:
+	QamModbusFrame() : m_size( 0 ) {}
+
+	/*! Entête MBAP ; le champ Length est fixé par updateLength(). */
+	inline void appendMbap(quint16 ti, quint16 pi, quint8 ui )
+	{
+		append16( ti ) ;
+		append16( pi ) ;
+		append16( 0 ) ;
+		append8( ui ) ;
+	}
+	/*! Copie des @a size premiers octets d'une trame reçue (entête, FC...). */
+	inline void appendFrom(const char* data, int size )
+	{
+		Q_ASSERT( m_size + size <= MODBUSPDU_MAX_ADU ) ;
+		std::memcpy( m_buf + m_size, data, size ) ;
+		m_size += size ;
+	}
+	inline void append8(quint8 value )
+	{
+		Q_ASSERT( m_size < MODBUSPDU_MAX_ADU ) ;
+		m_buf[ m_size++ ] = (char)value ;
+	}
+	inline void append16(quint16 value )
+	{
+		Q_ASSERT( m_size + 2 <= MODBUSPDU_MAX_ADU ) ;
+		QamModbusPdu::put16( m_buf + m_size, value ) ;
+		m_size += 2 ;
+	}
+	/*! Réserve @a size octets en fin de trame et retourne leur adresse. */
+	inline char* grow(int size )
+	{
+		Q_ASSERT( m_size + size <= MODBUSPDU_MAX_ADU ) ;
+		char* p = m_buf + m_size ;
+		m_size += size ;
+		return p ;
+	}
+	/*! Champ Length de l'entête MBAP mis à jour selon la taille de la trame. */
+	inline void updateLength() { QamModbusPdu::put16( m_buf + 4, m_size - 6 ) ; }
+
+	inline char* data() { return m_buf ; }
+	inline const char* constData() const { return m_buf ; }
+	inline int size() const { return m_size ; }
+	inline char& operator[](int i ) { return m_buf[i] ; }
+
+	/*! Copie de la trame dans un QByteArray (seule allocation). */
+	inline QByteArray toByteArray() const { return QByteArray( m_buf, m_size ) ; }
+
+  private:
+	char	m_buf[ MODBUSPDU_MAX_ADU ] ;
+	int		m_size ;
+} ;
+
+/*!
+ * Réponse d'exception à une requête : entête MBAP de la requête, PDU réduit au
+ * Function Code (bit 7 à 1) suivi du code d'exception.
+ * \param request : requête MBAP + PDU (8 octets au moins).
+ * \param exceptionCode : code d'exception Modbus.
+ */
+
+inline QByteArray QamModbusPdu::exceptionResponse(const QByteArray& request, quint8 exceptionCode )
+{
+	QamModbusFrame	resp ;
+	resp.appendFrom( request.constData(), 8 ) ;
+	resp[7] = resp[7] | 0x80 ;
+	resp.append8( exceptionCode ) ;
+	resp.updateLength() ;
+	return resp.toByteArray() ;
+}
+
+#endif // QAMMODBUSPDU_H
@@ -0,0 +1,397 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   qammodbuspush.cpp
+ *  description :   IMPLEMENTATION des classes QamModbusPushServer et QamModbusPushClient
+ *					Canal de notification des changements de valeurs
+ *
+ *	project     :	Qam Modbus over TCP/IP
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2014-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "Qam Modbus over IP Project"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#include "qammodbuspush.h"
+#include <QMutexLocker>
+#include <QHash>
+
+// taille maximale du PDU d'une trame MBAP (champ longueur <= 254)
+#define	MODBUSPUSH_MAX_PDU	253
+
+// ---------------------------------------------------------------------------
+// QamModbusPushServer
+// ---------------------------------------------------------------------------
+
+/*!
+ * Constructeur.
+ * \param map : cartographie (mode serveur) dont les changements sont diffusés.
+ * \param parent : parent Qt.
+ */
+
+QamModbusPushServer::QamModbusPushServer(QamModbusMap* map, QObject* parent )
+	: QamAbstractServer(parent)
+	, m_map( map )
+	, m_isDirty( false )
+{
+	for ( int i = 0 ; i < 5 ; ++i )	m_dirty[i].resize( 65536 ) ;
+
+	// les écritures des clients Modbus sont signalées depuis les threads de
+	// connexion : la connexion est alors différée dans le thread du canal
+	connect(m_map, SIGNAL(valueChanged(int,QString)), this, SLOT(valueChanged(int,QString)) ) ;
+
+	m_timer = new QTimer( this ) ;
+	connect(m_timer, SIGNAL(timeout()), this, SLOT(tick()) ) ;
+	m_timer->start( MODBUSPUSH_PERIOD ) ;
+}
+
+/*!
+ * Période de regroupement des changements : un client reçoit au plus une
+ * écriture par période.
+ * \param ms : période en millisecondes (1 au moins).
+ */
+
+void QamModbusPushServer::setPeriod(int ms )
+{
+	m_timer->start( qMax( 1, ms ) ) ;
+}
+
+/*! Nombre d'abonnements en cours, tous clients confondus. */
+
+int QamModbusPushServer::subscriptionCount() const
+{
+	QMutexLocker	lock( &m_mutex ) ;
+	return m_subscriptions.count() ;
+}
+
+/*! Découpage du flux en trames MBAP (cf. QamModbusPdu::frameLength()). */
+
+int QamModbusPushServer::frameLength(const char* data, int size ) const
+{
+	return QamModbusPdu::frameLength( data, size ) ;
+}
+
+/*!
+ * Fin de session d'un client : suppression de ses abonnements.
+ */
+
+void QamModbusPushServer::sessionClosed(quint64 session )
+{
+	QMutexLocker	lock( &m_mutex ) ;
+
+	for ( int i = m_subscriptions.count() - 1 ; i >= 0 ; --i ) {
+		if ( m_subscriptions.at(i).session == session )	m_subscriptions.removeAt(i) ;
+	}
+}
+
+/*!
+ * Traitement des requêtes d'abonnement (FC65) et de désabonnement (FC66).
+ * \param session : session cliente.
+ * \param request : trame MBAP + PDU.
+ * \return Echo de la requête, ou réponse d'exception (01 : fonction non
+ * supportée, 02 : plage hors table, 03 : PDU incorrect).
+ */
+
+QByteArray QamModbusPushServer::responseToSessionRequest(quint64 session, QByteArray& request )
+{
+	if ( request.size() < 8 )	return QByteArray() ;
+
+	quint8 funct = (quint8)request.at(7) ;
+
+	if (( funct != MODBUSPUSH_FC_SUBSCRIBE )&&( funct != MODBUSPUSH_FC_UNSUBSCRIBE ))	return QamModbusPdu::exceptionResponse( request, 0x01 ) ;
+	if ( request.size() != 13 )	return QamModbusPdu::exceptionResponse( request, 0x03 ) ;
+
+	Subscription	sub ;
+	quint8			table = (quint8)request.at(8) ;
+	sub.session = session ;
+	sub.table = (QamModbusMap::PrimaryTable)table ;
+	sub.address = ( (quint8)request.at(9) << 8 ) + (quint8)request.at(10) ;
+	sub.count = ( (quint8)request.at(11) << 8 ) + (quint8)request.at(12) ;
+
+	if ( table > QamModbusMap::HoldingRegister )	return QamModbusPdu::exceptionResponse( request, 0x02 ) ;
+	if ( sub.address + sub.count > m_map->m_store[ table ].size() )	return QamModbusPdu::exceptionResponse( request, 0x02 ) ;
+
+	QMutexLocker	lock( &m_mutex ) ;
+
+	if ( funct == MODBUSPUSH_FC_SUBSCRIBE ) {
+		if ( sub.count == 0 )	return QamModbusPdu::exceptionResponse( request, 0x03 ) ;
+		m_subscriptions << sub ;
+	}
+	else {
+		for ( int i = m_subscriptions.count() - 1 ; i >= 0 ; --i ) {
+			const Subscription& s = m_subscriptions.at(i) ;
+			if ( s.session != session )	continue ;
+			if (( sub.count == 0 )||(( s.table == sub.table )&&( s.address == sub.address )&&( s.count == sub.count )))	m_subscriptions.removeAt(i) ;
+		}
+	}
+
+	emit received( request ) ;
+	return request ;
+}
+
+// [private slot] marquage des adresses d'une donnée modifiée
+
+void QamModbusPushServer::valueChanged(int table, const QString& name )
+{
+	QamModbusMap::Handle h = m_map->handle( (QamModbusMap::PrimaryTable)table, name ) ;
+	if ( !h.isValid() )	return ;
+
+	QBitArray& dirty = m_dirty[ table ] ;
+	for ( int i = 0 ; i < h.words ; ++i )	dirty.setBit( h.address + i ) ;
+	m_isDirty = true ;
+}
+
+// [private slot] diffusion périodique : une écriture par client, regroupant
+// les suites modifiées de tous ses abonnements
+
+void QamModbusPushServer::tick()
+{
+	if ( !m_isDirty )	return ;
+
+	QList<Subscription>	subscriptions ;
+	{
+		QMutexLocker	lock( &m_mutex ) ;
+		subscriptions = m_subscriptions ;
+	}
+
+	QHash<quint64,QByteArray>	frames ;
+	QVector<quint16>			words ;
+
+	for ( int i = 0 ; i < subscriptions.count() ; ++i ) {
+		const Subscription& sub = subscriptions.at(i) ;
+		const QBitArray& dirty = m_dirty[ sub.table ] ;
+
+		int first = sub.address ;
+		while (( first < sub.address + sub.count )&&( !dirty.testBit( first ) ))	++first ;
+		if ( first == sub.address + sub.count )	continue ;		// rien de modifié
+
+		words.resize( sub.count ) ;
+		m_map->readWords( sub.table, sub.address, sub.count, words.data() ) ;
+		appendDelta( frames[ sub.session ], sub, words.constData() ) ;
+	}
+
+	for ( int i = 0 ; i < 5 ; ++i )	m_dirty[i].fill( false ) ;
+	m_isDirty = false ;
+
+	// remise directe à chaque session destinataire
+	for ( QHash<quint64,QByteArray>::const_iterator it = frames.constBegin() ; it != frames.constEnd() ; ++it ) {
+		if ( !it.value().isEmpty() )	push( it.key(), it.value() ) ;
+	}
+}
+
+// [private] trame(s) FC67 d'un abonnement : suites d'adresses modifiées,
+// découpées pour respecter la taille maximale d'un PDU
+
+void QamModbusPushServer::appendDelta(QByteArray& out, const Subscription& sub, const quint16* words ) const
+{
+	const QBitArray&	dirty = m_dirty[ sub.table ] ;
+	QByteArray			runs ;
+	int					nruns = 0 ;
+
+	auto flush = [&]() {
+		if ( nruns == 0 )	return ;
+		quint16 len = 1 + 3 + runs.size() ;			// UI + FC, table, nombre de suites
+		out.append( (char)0 ) ;						// TI
+		out.append( (char)0 ) ;
+		out.append( (char)0 ) ;						// PI
+		out.append( (char)0 ) ;
+		out.append( ( len >> 8 ) & 0xFF ) ;
+		out.append( len & 0xFF ) ;
+		out.append( (char)0xFF ) ;					// UI
+		out.append( (char)MODBUSPUSH_FC_DELTA ) ;
+		out.append( (char)sub.table ) ;
+		out.append( (char)nruns ) ;
+		out.append( runs ) ;
+		runs.clear() ;
+		nruns = 0 ;
+	} ;
+
+	int i = 0 ;
+	while ( i < sub.count ) {
+		if ( !dirty.testBit( sub.address + i ) ) {
+			++i ;
+			continue ;
+		}
+		int n = 1 ;
+		while (( i + n < sub.count )&&( dirty.testBit( sub.address + i + n ) ))	++n ;
+
+		while ( n > 0 ) {
+			int room = ( MODBUSPUSH_MAX_PDU - 3 - runs.size() - 3 ) / 2 ;
+			if (( room < 1 )||( nruns == 255 )) {
+				flush() ;
+				continue ;
+			}
+			int k = qMin( qMin( n, room ), 255 ) ;
+			quint16 addr = sub.address + i ;
+			runs.append( ( addr >> 8 ) & 0xFF ) ;
+			runs.append( addr & 0xFF ) ;
+			runs.append( (char)k ) ;
+			for ( int j = 0 ; j < k ; ++j ) {
+				runs.append( ( words[ i + j ] >> 8 ) & 0xFF ) ;
+				runs.append( words[ i + j ] & 0xFF ) ;
+			}
+			++nruns ;
+			i += k ;
+			n -= k ;
+		}
+	}
+	flush() ;
+}
+
+// ---------------------------------------------------------------------------
+// QamModbusPushClient
+// ---------------------------------------------------------------------------
+
+/*!
+ * Constructeur.
+ * \param map : cartographie (mode client) mise à jour par le canal.
+ * \param parent : parent Qt.
+ */
+
+QamModbusPushClient::QamModbusPushClient(QamModbusMap* map, QObject* parent )
+	: QamAbstractServer(parent)
+	, m_map( map )
+	, m_isServerAvailable( false )
+	, m_ti( 0 )
+{
+}
+
+/*!
+ * Abonnement à une plage d'adresses ; la requête est émise immédiatement
+ * si le canal est connecté, et renouvelée à chaque connexion.
+ * \param table : table concernée.
+ * \param address : première adresse.
+ * \param count : nombre d'adresses.
+ */
+
+void QamModbusPushClient::subscribe(QamModbusMap::PrimaryTable table, quint16 address, quint16 count )
+{
+	if ( count == 0 )	return ;
+
+	Range	r = { table, address, count } ;
+	m_ranges << r ;
+	if ( m_isServerAvailable )	sendRequest( MODBUSPUSH_FC_SUBSCRIBE, r ) ;
+}
+
+/*!
+ * Désabonnement d'une plage précédemment souscrite (mêmes arguments), ou de
+ * toutes les plages si @a count est nul.
+ */
+
+void QamModbusPushClient::unsubscribe(QamModbusMap::PrimaryTable table, quint16 address, quint16 count )
+{
+	Range	r = { table, address, count } ;
+
+	for ( int i = m_ranges.count() - 1 ; i >= 0 ; --i ) {
+		const Range& s = m_ranges.at(i) ;
+		if (( count == 0 )||(( s.table == table )&&( s.address == address )&&( s.count == count )))	m_ranges.removeAt(i) ;
+	}
+	if ( m_isServerAvailable )	sendRequest( MODBUSPUSH_FC_UNSUBSCRIBE, r ) ;
+}
+
+/*!
+ * Etat de la connexion (méthode invoquée par QamTcpClient) : les abonnements
+ * sont renouvelés à chaque connexion.
+ */
+
+void QamModbusPushClient::setServerAvailable(bool serverAvailable )
+{
+	m_isServerAvailable = serverAvailable ;
+	if ( !serverAvailable )	return ;
+
+	for ( int i = 0 ; i < m_ranges.count() ; ++i )	sendRequest( MODBUSPUSH_FC_SUBSCRIBE, m_ranges.at(i) ) ;
+}
+
+/*! Découpage du flux en trames MBAP (cf. QamModbusPdu::frameLength()). */
+
+int QamModbusPushClient::frameLength(const char* data, int size ) const
+{
+	return QamModbusPdu::frameLength( data, size ) ;
+}
+
+/*!
+ * Traitement d'une trame reçue du serveur : application des changements
+ * (FC67), les acquittements d'abonnement sont seulement remontés par le
+ * signal received().
+ */
+
+void QamModbusPushClient::responseFromServer(QByteArray response )
+{
+	if ( response.size() < 9 )	return ;
+
+	quint8 funct = (quint8)response.at(7) ;
+
+	if ( funct == MODBUSPUSH_FC_DELTA )	applyDelta( response ) ;
+	else if ( funct & 0x80 )	networkInfo( QString("push: exception %1").arg( (quint8)response.at(8) ) ) ;
+	else	emit received( response ) ;
+}
+
+// [private] émission d'une requête d'abonnement / de désabonnement
+
+void QamModbusPushClient::sendRequest(quint8 funct, const Range& range )
+{
+	++m_ti ;
+
+	QByteArray	frame ;
+	frame.append( ( m_ti >> 8 ) & 0xFF ) ;
+	frame.append( m_ti & 0xFF ) ;
+	frame.append( (char)0 ) ;				// PI
+	frame.append( (char)0 ) ;
+	frame.append( (char)0 ) ;				// longueur
+	frame.append( (char)7 ) ;
+	frame.append( (char)0xFF ) ;			// UI
+	frame.append( funct ) ;
+	frame.append( (char)range.table ) ;
+	frame.append( ( range.address >> 8 ) & 0xFF ) ;
+	frame.append( range.address & 0xFF ) ;
+	frame.append( ( range.count >> 8 ) & 0xFF ) ;
+	frame.append( range.count & 0xFF ) ;
+
+	emit request( frame ) ;
+}
+
+// [private] application d'une trame FC67 à la cartographie : les mots des
+// suites sont écrits en une section, la cartographie émettant ensuite
+// valuesChanged() pour les données concernées
+
+void QamModbusPushClient::applyDelta(const QByteArray& frame )
+{
+	quint8 table = (quint8)frame.at(8) ;
+	if (( table > QamModbusMap::HoldingRegister )||( frame.size() < 10 ))	return ;
+
+	quint16		addresses[ MODBUSPUSH_MAX_PDU / 2 ] ;
+	quint16		values[ MODBUSPUSH_MAX_PDU / 2 ] ;
+	int			count = 0 ;
+	quint8		nruns = (quint8)frame.at(9) ;
+	int			pos = 10 ;
+
+	for ( int r = 0 ; r < nruns ; ++r ) {
+		if ( pos + 3 > frame.size() )	break ;
+		quint16 addr = QamModbusPdu::get16( frame.constData() + pos ) ;
+		quint8	n = (quint8)frame.at( pos + 2 ) ;
+		pos += 3 ;
+		if (( pos + n * 2 > frame.size() )||( count + n > MODBUSPUSH_MAX_PDU / 2 ))	break ;
+
+		for ( int i = 0 ; i < n ; ++i ) {
+			addresses[ count ] = addr + i ;
+			values[ count ] = QamModbusPdu::get16( frame.constData() + pos ) ;
+			++count ;
+			pos += 2 ;
+		}
+	}
+
+	if ( count )	m_map->setLocalWords( (QamModbusMap::PrimaryTable)table, addresses, values, count ) ;
+}
@@ -0,0 +1,175 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   qammodbuspush.h
+ *  description :   INTERFACE des classes QamModbusPushServer et QamModbusPushClient
+ *					Canal de notification des changements de valeurs
+ *
+ *	project     :	Qam Modbus over TCP/IP
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2014-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "Qam Modbus over IP Project"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#ifndef QAMMODBUSPUSH_H
+#define QAMMODBUSPUSH_H
+
+/*!
+  @file
+  @brief Canal de notification des changements de valeurs d'une cartographie
+ */
+
+/*!
+ @class QamModbusPushServer
+ @brief Canal de notification des changements de valeurs (côté serveur).
+
+Extension facultative d'un serveur Modbus/TCP destinée aux clients de simple
+visualisation : au lieu de scruter les registres, le client s'abonne à des
+plages d'adresses et le serveur lui envoie les valeurs modifiées. Le canal
+est servi par un second QamTcpServer, en général sur le port suivant celui
+de la cartographie (MODBUSPUSH_PORT_OFFSET).
+
+Les trames suivent l'entête MBAP de Modbus/TCP, avec des codes fonction
+de la plage réservée aux usages propres :
+- 65 (abonnement) et 66 (désabonnement), du client vers le serveur :
+  table (1 octet, cf. QamModbusMap::PrimaryTable), adresse (2 octets),
+  nombre d'adresses (2 octets) ; la réponse est l'écho de la requête, un
+  désabonnement de 0 adresse supprime tous les abonnements du client ;
+- 67 (changements), émise spontanément par le serveur (TI = 0) : table
+  (1 octet), nombre de suites (1 octet), puis pour chaque suite : adresse
+  (2 octets), nombre de mots N (1 octet) et N valeurs 16 bits (une par
+  adresse, 0 ou 1 pour les tables de bits).
+
+Les signaux valueChanged() de la cartographie marquent les adresses
+modifiées ; à chaque période (setPeriod()), chaque client reçoit en une
+seule écriture les suites modifiées de ses abonnements, lues en un
+instantané cohérent de la cartographie.
+
+@code
+	push = new QamModbusPushServer(map, this ) ;
+	pushServer = new QamTcpServer(push, this ) ;
+	pushServer->start( map->port() + MODBUSPUSH_PORT_OFFSET ) ;
+@endcode
+ */
+
+/*!
+ @class QamModbusPushClient
+ @brief Canal de notification des changements de valeurs (côté client).
+
+La classe QamModbusPushClient applique à une cartographie en mode client
+les changements reçus d'un QamModbusPushServer, puis émet le signal
+QamModbusMap::valuesChanged() de la cartographie (un signal par trame).
+Les abonnements sont renouvelés à chaque connexion.
+
+@code
+	push = new QamModbusPushClient(map, this ) ;
+	push->subscribe(QamModbusMap::HoldingRegister, 0, 16 ) ;
+	pushClient = new QamTcpClient(push, this ) ;
+	pushClient->sockConnect(map->host(), map->port() + MODBUSPUSH_PORT_OFFSET ) ;
+@endcode
+ */
+
+#include "../QamSockets/qamabstractserver.h"
+#include "qammodbusmap.h"
+#include <QBitArray>
+#include <QMutex>
+#include <QTimer>
+
+#define	MODBUSPUSH_FC_SUBSCRIBE		65
+#define	MODBUSPUSH_FC_UNSUBSCRIBE	66
+#define	MODBUSPUSH_FC_DELTA			67
+#define	MODBUSPUSH_PERIOD			20		// période de regroupement des changements (ms)
+#define	MODBUSPUSH_PORT_OFFSET		1		// port du canal : port Modbus + offset
+
+class QamModbusPushServer : public QamAbstractServer
+{
+	Q_OBJECT
+
+  public:
+	explicit QamModbusPushServer(QamModbusMap* map, QObject* parent = 0 ) ;
+
+	void setPeriod(int ms ) ;
+	/*! Période de regroupement des changements (ms). */
+	inline int period() const { return m_timer->interval() ; }
+	int subscriptionCount() const ;
+
+	virtual int frameLength(const char* data, int size ) const ;
+	virtual void sessionClosed(quint64 session ) ;
+
+  public slots:
+	virtual QByteArray responseToSessionRequest(quint64 session, QByteArray& request ) ;
+
+  private slots:
+	void valueChanged(int table, const QString& name ) ;
+	void tick() ;
+
+  private:
+	/* plage d'adresses suivie par un client */
+	struct Subscription {
+		quint64							session ;
+		QamModbusMap::PrimaryTable		table ;
+		quint16							address ;
+		quint16							count ;
+	} ;
+
+	void appendDelta(QByteArray& out, const Subscription& sub, const quint16* words ) const ;
+
+  private:
+	QamModbusMap*			m_map ;
+	QTimer*					m_timer ;
+	mutable QMutex			m_mutex ;			// abonnements (threads des sessions)
+	QList<Subscription>		m_subscriptions ;
+	QBitArray				m_dirty[5] ;		// adresses modifiées depuis la dernière période
+	bool					m_isDirty ;
+} ;
+
+class QamModbusPushClient : public QamAbstractServer
+{
+	Q_OBJECT
+
+  public:
+	explicit QamModbusPushClient(QamModbusMap* map, QObject* parent = 0 ) ;
+
+	void subscribe(QamModbusMap::PrimaryTable table, quint16 address, quint16 count ) ;
+	void unsubscribe(QamModbusMap::PrimaryTable table, quint16 address, quint16 count ) ;
+
+	virtual void setServerAvailable(bool serverAvailable ) ;
+	virtual int frameLength(const char* data, int size ) const ;
+	/*! Vrai si le canal est connecté. */
+	inline bool isAvailable() const { return m_isServerAvailable ; }
+
+  public slots:
+	virtual void responseFromServer(QByteArray response ) ;
+
+  private:
+	struct Range {
+		QamModbusMap::PrimaryTable		table ;
+		quint16							address ;
+		quint16							count ;
+	} ;
+
+	void sendRequest(quint8 funct, const Range& range ) ;
+	void applyDelta(const QByteArray& frame ) ;
+
+  private:
+	QamModbusMap*	m_map ;
+	QList<Range>	m_ranges ;				// abonnements, renouvelés à la connexion
+	bool			m_isServerAvailable ;
+	quint16			m_ti ;
+} ;
+
+#endif // QAMMODBUSPUSH_H
@@ -25,11 +25,13 @@
  */
 
 #include "qamabstractserver.h"
+#include "qamtcpsession.h"
 
 /*! Constructeur. */
 
 QamAbstractServer::QamAbstractServer(QObject* parent)
 	: QObject(parent)
+	, m_lastSession( 0 )
 {
 }
 
@@ -44,6 +46,26 @@ void QamAbstractServer::setServerAvailable(bool serverAvailable )
 	Q_UNUSED( serverAvailable ) ;
 }
 
+/*!
+ * Mode Serveur TCP : découpage du flux reçu par QamTcpConnection en requêtes
+ * (new v3.4). Les données reçues sont accumulées par la connexion ; cette
+ * méthode est invoquée tant qu'elle retourne une requête complète, chaque
+ * requête étant ensuite transmise à responseToClientRequest().
+ * Par défaut, toutes les données disponibles forment une seule requête
+ * (comportement des versions antérieures) ; un protocole dont les trames
+ * portent leur longueur doit spécialiser cette méthode.
+ * \param data : début des données reçues non encore traitées.
+ * \param size : nombre d'octets disponibles.
+ * \return Longueur de la requête complète en tête de @a data, 0 si la requête
+ * est incomplète, -1 si le flux est invalide (la connexion est alors fermée).
+ */
+
+int QamAbstractServer::frameLength(const char* data, int size ) const
+{
+	Q_UNUSED( data ) ;
+	return size ;
+}
+
 /*!
  * Mode Serveur TCP : connecteur utilisé par QamTcpServer / QamTcpConnection pour 
  * permettre la fabrication d'une réponse à une requête cliente.
@@ -64,6 +86,78 @@ QByteArray QamAbstractServer::responseToRequest(QByteArray& request )	// OBSOLET
 	return this->responseToClientRequest( request ) ;
 }
 
+/*!
+ * Mode Serveur TCP : variante de responseToClientRequest() invoquée par les
+ * sessions de QamTcpServer avec l'identifiant de la session cliente (new v3.7),
+ * pour un serveur "métier" qui doit associer un état à chaque client (voir
+ * push() et sessionClosed()). Par défaut, la requête est transmise à
+ * responseToClientRequest().
+ * \param session : identifiant de la session, unique pour la durée de vie du
+ * serveur "métier" (v3.9 ; descripteur de socket, réutilisable, auparavant).
+ * \param request : requête reçue.
+ */
+
+QByteArray QamAbstractServer::responseToSessionRequest(quint64 session, QByteArray& request )
+{
+	Q_UNUSED( session ) ;
+	return this->responseToClientRequest( request ) ;
+}
+
+/*!
+ * Mode Serveur TCP : fin d'une session cliente (new v3.7). Méthode invoquée
+ * dans le thread de la session ; sans effet par défaut.
+ * \param session : identifiant de la session.
+ */
+
+void QamAbstractServer::sessionClosed(quint64 session )
+{
+	Q_UNUSED( session ) ;
+}
+
+/*!
+ * Mode Serveur TCP : émission spontanée de @a data vers le client de la
+ * session @a session (new v3.9, signal diffusé à toutes les sessions en
+ * v3.7). Les données sont remises directement à la session destinataire,
+ * dans son thread ; la méthode peut être invoquée depuis n'importe quel
+ * thread.
+ * \param session : identifiant de la session.
+ * \param data : données à émettre.
+ * \return false si la session est close.
+ */
+
+bool QamAbstractServer::push(quint64 session, const QByteArray& data )
+{
+	// le verrou est conservé pendant le dépôt de l'appel : la session ne
+	// peut être détruite avant (cf. detachSession())
+	QMutexLocker	lock( &m_sessionsMutex ) ;
+
+	QamTcpSession* target = m_sessions.value( session, nullptr ) ;
+	if ( !target )	return false ;
+
+	QMetaObject::invokeMethod( target, [target, data]() { target->send( data ) ; }, Qt::QueuedConnection ) ;
+	return true ;
+}
+
+// [private] enregistrement d'une session ouverte (QamTcpSession::open()),
+// retourne son identifiant
+
+quint64 QamAbstractServer::attachSession(QamTcpSession* session )
+{
+	QMutexLocker	lock( &m_sessionsMutex ) ;
+
+	quint64 id = ++m_lastSession ;
+	m_sessions.insert( id, session ) ;
+	return id ;
+}
+
+// [private] retrait d'une session, avant sa destruction
+
+void QamAbstractServer::detachSession(quint64 session )
+{
+	QMutexLocker	lock( &m_sessionsMutex ) ;
+	m_sessions.remove( session ) ;
+}
+
 /*!
  * Mode Client TCP : connecteur invoqué par QamTcpClient pour permettre le traitement d'une 
  * réponse reçue suite à l'émission d'une requête via le signal request().
@@ -139,20 +139,30 @@ Soit une classe Qt d'usage disposant :
 
 #include <QObject>
 #include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+class QamTcpSession ;
 
 class QamAbstractServer : public QObject
 {
 	Q_OBJECT
 
+	friend class QamTcpSession ;	// registre des sessions (new v3.9)
+
   public:
 	explicit QamAbstractServer(QObject* parent = 0 ) ;
 
 	virtual void setServerAvailable(bool serverAvailable ) ;
+	virtual int frameLength(const char* data, int size ) const ;	// new v3.4
+	virtual void sessionClosed(quint64 session ) ;					// new v3.7
+	bool push(quint64 session, const QByteArray& data ) ;			// new v3.9
 
   public slots:
   	/*! \internal OBSOLETE : méthode remplacée par responseToClientRequest() */
 	virtual QByteArray responseToRequest(QByteArray& request ) ;
 	virtual QByteArray responseToClientRequest(QByteArray& request ) ;
+	virtual QByteArray responseToSessionRequest(quint64 session, QByteArray& request ) ;	// new v3.7
   	/*! \internal OBSOLETE : méthode remplacée par responseFromServer() */
 	virtual void response(QByteArray response ) ;
 	virtual void responseFromServer(QByteArray response ) ;
@@ -167,6 +177,15 @@ class QamAbstractServer : public QObject
 	void sent(const QByteArray& data ) ;
 	/*! Indicateur de message d'information. */
 	void info(const QString& message ) ;
+
+  private:
+	quint64 attachSession(QamTcpSession* session ) ;
+	void detachSession(quint64 session ) ;
+
+  private:
+	QMutex							m_sessionsMutex ;
+	QHash<quint64,QamTcpSession*>	m_sessions ;		// sessions ouvertes, par identifiant
+	quint64							m_lastSession ;		// dernier identifiant attribué
 } ;
 
 #endif // QAMABSTRACTSERVER_H
@@ -39,6 +39,8 @@ HEADERS	+=	\
 	$$PWD/qamtcpclient.h \
 	$$PWD/qamtcpconnection.h \
 	$$PWD/qamtcpserver.h \
+	$$PWD/qamtcpsession.h \
+	$$PWD/qamtrace.h \
 	$$PWD/qamudpsocket.h
 				
 SOURCES	+=	\
@@ -46,6 +48,8 @@ SOURCES	+=	\
 	$$PWD/qamtcpclient.cpp \
 	$$PWD/qamtcpconnection.cpp \
 	$$PWD/qamtcpserver.cpp \
+	$$PWD/qamtcpsession.cpp \
+	$$PWD/qamtrace.cpp \
 	$$PWD/qamudpsocket.cpp
 
 DISTFILES += \
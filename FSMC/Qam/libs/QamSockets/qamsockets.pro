@@ -45,12 +45,16 @@ HEADERS		+=	qamabstractserver.h \
 				qamtcpclient.h \
 				qamtcpconnection.h \
 				qamtcpserver.h \
+				qamtcpsession.h \
+				qamtrace.h \
 				qamudpsocket.h
 				
 SOURCES		+=	qamabstractserver.cpp \
 				qamtcpclient.cpp \
 				qamtcpconnection.cpp \
 				qamtcpserver.cpp \
+				qamtcpsession.cpp \
+				qamtrace.cpp \
 				qamudpsocket.cpp
 
 # MacOSX Framework
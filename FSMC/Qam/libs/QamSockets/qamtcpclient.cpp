@@ -113,13 +113,37 @@ void QamTcpClient::sockConnected()
 
 void QamTcpClient::sockDisconnected()
 {
+	m_rxBuffer.clear() ;
 	if ( m_server ) m_server->setServerAvailable( false ) ;
 }
 
+// les données reçues sont découpées en réponses par le serveur "métier"
+// (QamAbstractServer::frameLength()), une émission de sockReceived() par
+// réponse ; sans serveur "métier", toutes les données sont transmises
+
 void QamTcpClient::sockRead()
 {
-	QByteArray  data = this->readAll() ;
-	emit sockReceived( data ) ;
+	if ( !m_server ) {
+		QByteArray  data = this->readAll() ;
+		emit sockReceived( data ) ;
+		return ;
+	}
+
+	m_rxBuffer.append( this->readAll() ) ;
+
+	int offset = 0 ;
+	while ( offset < m_rxBuffer.size() ) {
+		int len = m_server->frameLength( m_rxBuffer.constData() + offset, m_rxBuffer.size() - offset ) ;
+		if ( len == 0 )	break ;
+		if ( len < 0 ) {
+			emit sockInfo( "invalid frame received" ) ;
+			offset = m_rxBuffer.size() ;
+			break ;
+		}
+		emit sockReceived( m_rxBuffer.mid( offset, len ) ) ;
+		offset += len ;
+	}
+	m_rxBuffer.remove( 0, offset ) ;
 }
 
 void QamTcpClient::sockError(QAbstractSocket::SocketError error )
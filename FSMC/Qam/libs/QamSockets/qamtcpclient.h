@@ -83,6 +83,7 @@ class QamTcpClient : public QTcpSocket
 
   private:
 	QamAbstractServer*	m_server ;
+	QByteArray			m_rxBuffer ;		// réponse incomplète (new v3.6)
 } ;
 
 #endif // QAMTCPCLIENT_H
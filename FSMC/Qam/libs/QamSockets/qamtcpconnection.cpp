@@ -41,52 +41,20 @@ QamTcpConnection::QamTcpConnection(qintptr id, QamAbstractServer* server, QObjec
 }
 
 /*!
- * Corps d'exécution du thread. Création de la socket cliente et gestion de la connexion.
+ * Corps d'exécution du thread. Création de la session cliente et gestion de la
+ * connexion ; la déconnexion du client provoque la fin de vie du thread.
  */
 
 void QamTcpConnection::run()
 {
 //	m_dataServer->networkInfo("Connection thread started...") ;
 
-	m_socket = new QTcpSocket() ;
+	QamTcpSession	session( m_socketDescriptor, m_dataServer ) ;
 
-	if ( !m_socket->setSocketDescriptor(m_socketDescriptor) ) {
-		m_dataServer->networkInfo( m_socket->errorString() ) ;
-		return ;
-	}
+	connect( &session,	SIGNAL(closed(qintptr)),
+			 this,		SLOT(quit()), Qt::DirectConnection ) ;
 
-	connect( m_socket,	SIGNAL(readyRead()),
-			 this,		SLOT(readyRead()), Qt::DirectConnection ) ;
-	connect( m_socket,	SIGNAL(disconnected()),
-			 this,		SLOT(disconnected()) ) ;
-
-	m_dataServer->networkInfo( QString("Client %1 connected").arg(m_socketDescriptor) ) ;
+	if ( !session.open() )	return ;
 
 	exec() ;
 }
-
-/*!
- * Connecteur de réception d'une requête client. La demande est transmise au serveur
- * "métier" qui à charge de fournir la réponse à retourner au client.
- */
-
-void QamTcpConnection::readyRead()
-{
-	QByteArray frame = m_socket->readAll() ;
-	m_dataServer->networkInfo( QString("Request from client %1").arg(m_socketDescriptor) ) ;
-	QByteArray response = m_dataServer->responseToClientRequest( frame ) ;
-	if ( !response.isEmpty() )	m_socket->write( response ) ;
-}
-
-/*!
- * Connecteur de détection de la déconnexion par le client. Cette action provoque
- * la fin de vie du thread.
- */
-
-void QamTcpConnection::disconnected()
-{
-	m_dataServer->networkInfo( QString("Client %1 disconnected").arg(m_socketDescriptor) ) ;
-
-	m_socket->deleteLater() ;
-	exit( 0 ) ;
-}
@@ -41,11 +41,14 @@
  requêtes l'objet dérivé de QamAbstractServer (classe abstraite) reçu lors de
  la construction. Le serveur est aussi destinataire de différents messages de
  suivi de connexion et/ou d'erreur.
+
+ Depuis la version 3.5, le dialogue est délégué à une QamTcpSession servie
+ par la boucle d'événements du thread (mode QamTcpServer::ThreadPerConnection).
  */
 
 #include <QThread>
-#include <QTcpSocket>
 #include "qamabstractserver.h"
+#include "qamtcpsession.h"
 
 class QamTcpConnection : public QThread
 {
@@ -55,12 +58,7 @@ class QamTcpConnection : public QThread
 	explicit QamTcpConnection(qintptr id, QamAbstractServer* server, QObject* parent = 0 ) ;
 	void run() ;
 
-  private slots:
-	void readyRead() ;
-	void disconnected() ;
-
   private:
-	QTcpSocket*			m_socket ;				// socket cliente
 	qintptr				m_socketDescriptor ;
 	QamAbstractServer*	m_dataServer ;			// serveur métier
 } ;
@@ -36,9 +36,20 @@ QamTcpServer::QamTcpServer(QamAbstractServer* server, QObject* parent )
 	: QTcpServer(parent)
 	, m_port( 4000 )
 	, m_dataServer( server )
+	, m_mode( ThreadPerConnection )
+	, m_maxConnections( 0 )
+	, m_connections( 0 )
+	, m_nextWorker( 0 )
 {
 }
 
+/*! Destructeur : fermeture des sessions et arrêt des threads du mode Reactor. */
+
+QamTcpServer::~QamTcpServer()
+{
+	stopWorkers() ;
+}
+
 /*!
  * Démarrage et mise en écoute du serveur.
  * \param listenPort : port de service.
@@ -55,6 +66,70 @@ void QamTcpServer::start(int listenPort )
 	}
 }
 
+/*!
+ * Choix du mode de prise en charge des connexions (new v3.5), à effectuer
+ * avant start().
+ * En mode Reactor, les sessions sont servies par la boucle d'événements du
+ * thread du serveur si @a workers est nul, sinon réparties sur @a workers
+ * threads créés par le serveur. Le serveur "métier" est alors invoqué depuis
+ * ces threads et doit le supporter (cas de QamModbusMap en mode serveur).
+ * \param mode : ThreadPerConnection ou Reactor.
+ * \param workers : nombre de threads du mode Reactor (0 : thread du serveur).
+ */
+
+void QamTcpServer::setMode(Mode mode, int workers )
+{
+	if ( isListening() ) {
+		m_dataServer->networkInfo( "Server mode can't be changed while listening" ) ;
+		return ;
+	}
+
+	stopWorkers() ;
+	m_mode = mode ;
+
+	if ( m_mode != Reactor )	return ;
+
+	for ( int i = 0 ; i < workers ; ++i ) {
+		QThread* worker = new QThread( this ) ;
+		QObject* anchor = new QObject ;
+		anchor->moveToThread( worker ) ;
+		worker->start() ;
+		m_workers << worker ;
+		m_anchors << anchor ;
+	}
+}
+
+/*! Mode de prise en charge des connexions. */
+
+QamTcpServer::Mode QamTcpServer::mode() const
+{
+	return m_mode ;
+}
+
+/*!
+ * Limitation du nombre de connexions simultanées (new v3.5).
+ * \param max : nombre maximal de clients, 0 pour ne pas limiter.
+ */
+
+void QamTcpServer::setMaxConnections(int max )
+{
+	m_maxConnections = qMax( 0, max ) ;
+}
+
+/*! Nombre maximal de connexions simultanées (0 : pas de limite). */
+
+int QamTcpServer::maxConnections() const
+{
+	return m_maxConnections ;
+}
+
+/*! Nombre de connexions actives. */
+
+int QamTcpServer::connectionCount() const
+{
+	return m_connections ;
+}
+
 void QamTcpServer::sockClose()
 {
 	close() ;
@@ -62,18 +137,102 @@ void QamTcpServer::sockClose()
 }
 
 /*!
- * Réponse à une demande de connexion par création d'un nouveau thread dédié de classe
- * QamTcpConnection à qui est transmis l'adresse du serveur "métier" à utiliser
- * comme interlocuteur.
+ * Réponse à une demande de connexion. En mode ThreadPerConnection, création d'un
+ * nouveau thread dédié de classe QamTcpConnection ; en mode Reactor, création
+ * d'une QamTcpSession servie par le thread du serveur ou par l'un des threads
+ * de service. Dans les deux cas, l'adresse du serveur "métier" à utiliser comme
+ * interlocuteur est transmise. Au-delà de maxConnections(), le client est refusé.
  * \param socketDescriptor : descripteur de socket associé à la connexion.
  */
 
 void QamTcpServer::incomingConnection(qintptr socketDescriptor )
 {
-	QamTcpConnection* tcpConnection = new QamTcpConnection(socketDescriptor, m_dataServer, this ) ;
+	if (( m_maxConnections > 0 )&&( m_connections >= m_maxConnections )) {
+		QTcpSocket	socket ;
+		socket.setSocketDescriptor( socketDescriptor ) ;
+		socket.abort() ;
+		m_dataServer->networkInfo( QString("Client %1 refused (%2 connections)").arg(socketDescriptor).arg(m_connections) ) ;
+		return ;
+	}
 
-	connect( tcpConnection, SIGNAL(finished()),
-			 tcpConnection, SLOT(deleteLater()) ) ;
+	++m_connections ;
+
+	if ( m_mode == ThreadPerConnection ) {
+		QamTcpConnection* tcpConnection = new QamTcpConnection(socketDescriptor, m_dataServer, this ) ;
+
+		connect( tcpConnection, SIGNAL(finished()),
+				 tcpConnection, SLOT(deleteLater()) ) ;
+		connect( tcpConnection, SIGNAL(finished()),
+				 this,			SLOT(connectionClosed()) ) ;
+
+		tcpConnection->start() ;
+		return ;
+	}
+
+	// mode Reactor : la session n'a pas de parent pour pouvoir changer de thread
+
+	QamTcpSession* session = new QamTcpSession(socketDescriptor, m_dataServer ) ;
+
+	connect( session,	SIGNAL(closed(qintptr)),
+			 this,		SLOT(connectionClosed()) ) ;
+	connect( session,	SIGNAL(closed(qintptr)),
+			 session,	SLOT(deleteLater()) ) ;
+
+	if ( m_workers.isEmpty() ) {
+		session->setParent( this ) ;
+		session->open() ;
+		return ;
+	}
+
+	// la socket doit être créée dans le thread de la session, où la session
+	// est rattachée à l'objet parent de ce thread (cf. stopWorkers())
+	QObject* anchor = m_anchors.at( m_nextWorker ) ;
+	session->moveToThread( m_workers.at( m_nextWorker ) ) ;
+	m_nextWorker = ( m_nextWorker + 1 ) % m_workers.size() ;
+	QMetaObject::invokeMethod( anchor, [session, anchor]() {
+		session->setParent( anchor ) ;
+		session->open() ;
+	}, Qt::QueuedConnection ) ;
+}
 
-	tcpConnection->start() ;
+// [private] fin d'une connexion (thread terminé ou session close)
+
+void QamTcpServer::connectionClosed()
+{
+	if ( m_connections > 0 )	--m_connections ;
+}
+
+// [private] fermeture des sessions du mode Reactor, puis arrêt et
+// destruction des threads ; chaque session est fermée dans son thread avant
+// l'arrêt de la boucle, les destructions différées (deleteLater()) étant
+// traitées en fin de thread
+
+void QamTcpServer::stopWorkers()
+{
+	closeSessions( this ) ;
+
+	for ( int i = 0 ; i < m_workers.size() ; ++i ) {
+		QThread* worker = m_workers.at( i ) ;
+		QObject* anchor = m_anchors.at( i ) ;
+
+		QMetaObject::invokeMethod( anchor, [anchor]() {
+			closeSessions( anchor ) ;
+			anchor->deleteLater() ;
+		}, Qt::BlockingQueuedConnection ) ;
+
+		worker->quit() ;
+		worker->wait() ;
+		delete worker ;
+	}
+	m_workers.clear() ;
+	m_anchors.clear() ;
+	m_nextWorker = 0 ;
+}
+
+// [private] fermeture des sessions filles de 'parent' (thread de 'parent')
+
+void QamTcpServer::closeSessions(QObject* parent )
+{
+	const QList<QamTcpSession*> sessions = parent->findChildren<QamTcpSession*>( QString(), Qt::FindDirectChildrenOnly ) ;
+	for ( QamTcpSession* session : sessions )	session->close() ;
 }
@@ -40,30 +40,66 @@
  multi-clients. La logique applicative de réponse aux requêtes est assurée
  par un objet répondant au modèle de développement spécifié par la classe
  QamAbstractServer (voir documentation de QamAbstractServer).
+
+ Deux modes de fonctionnement sont disponibles (voir setMode()) :
+ - ThreadPerConnection (défaut) : un thread QamTcpConnection par client ;
+ - Reactor : les connexions (QamTcpSession) sont servies par la boucle
+ d'événements du serveur, ou réparties sur un nombre fixe de threads.
+
+ Le nombre de connexions simultanées peut être limité (voir
+ setMaxConnections()) ; au-delà, les nouveaux clients sont refusés.
  */
 
 #include "_ABOUT"
 #include <QTcpServer>
+#include <QList>
 #include "qamabstractserver.h"
 #include "qamtcpconnection.h"
+#include "qamtcpsession.h"
 
 class QamTcpServer : public QTcpServer
 {
 	Q_OBJECT
 
   public:
+	/*! Modes de prise en charge des connexions (new v3.5). */
+	enum Mode {
+		ThreadPerConnection,	//!< un thread par client
+		Reactor					//!< sessions servies par une ou plusieurs boucles d'événements
+	} ;
+
 	explicit QamTcpServer(QamAbstractServer* server, QObject* parent = 0 ) ;
+	~QamTcpServer() ;
 	void start(int listenPort = 4000 ) ;
 
+	void setMode(Mode mode, int workers = 0 ) ;								// new v3.5
+	Mode mode() const ;														// new v3.5
+	void setMaxConnections(int max ) ;										// new v3.5
+	int maxConnections() const ;											// new v3.5
+	int connectionCount() const ;											// new v3.5
+
   public slots :
 	void sockClose() ;
 
   protected:
 	virtual void incomingConnection(qintptr socketDescriptor ) ;
 
+  private slots:
+	void connectionClosed() ;
+
+  private:
+	void stopWorkers() ;
+	static void closeSessions(QObject* parent ) ;							// new v3.9
+
   private:
 	int					m_port ;
 	QamAbstractServer*	m_dataServer ;
+	Mode				m_mode ;
+	int					m_maxConnections ;		// 0 : pas de limite
+	int					m_connections ;			// connexions actives
+	QList<QThread*>		m_workers ;				// threads du mode Reactor
+	QList<QObject*>		m_anchors ;				// parent des sessions de chaque thread (new v3.9)
+	int					m_nextWorker ;			// répartition circulaire
 } ;
 
 #endif // QAMTCPSERVER_H
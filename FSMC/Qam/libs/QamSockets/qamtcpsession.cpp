@@ -0,0 +1,205 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   qamtcpsession.cpp
+ *  description :   IMPLEMENTATION de la classe QamTcpSession
+ *
+ *	project     :	QamSockets Library
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2006-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "QamSockets Library"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#include "qamtcpsession.h"
+#include "qamtrace.h"
+
+/*!
+ * Constructeur.
+ * \param id : descripteur socket de la connexion.
+ * \param server : serveur "métier" à utiliser comme interlocuteur.
+ * \param parent : parent Qt.
+ */
+
+QamTcpSession::QamTcpSession(qintptr id, QamAbstractServer* server, QObject* parent )
+	: QObject(parent)
+	, m_socket( 0 )
+	, m_socketDescriptor( id )
+	, m_session( 0 )
+	, m_dataServer( server )
+	, m_closed( false )
+{
+}
+
+/*! Destructeur : retrait du registre des sessions du serveur "métier". */
+
+QamTcpSession::~QamTcpSession()
+{
+	if ( m_session )	m_dataServer->detachSession( m_session ) ;
+}
+
+/*! Descripteur socket de la connexion. */
+
+qintptr QamTcpSession::id() const
+{
+	return m_socketDescriptor ;
+}
+
+/*!
+ * Identifiant de la session auprès du serveur "métier" (new v3.9), unique
+ * pour toute la durée de vie de celui-ci ; 0 avant open().
+ */
+
+quint64 QamTcpSession::sessionId() const
+{
+	return m_session ;
+}
+
+/*!
+ * Création de la socket cliente dans le thread courant. En cas d'échec, le
+ * signal closed() est émis.
+ * \return true si la connexion est prise en charge.
+ */
+
+bool QamTcpSession::open()
+{
+	m_socket = new QTcpSocket( this ) ;
+
+	if ( !m_socket->setSocketDescriptor(m_socketDescriptor) ) {
+		m_dataServer->networkInfo( m_socket->errorString() ) ;
+		m_closed = true ;
+		emit closed( m_socketDescriptor ) ;
+		return false ;
+	}
+
+	connect( m_socket,	SIGNAL(readyRead()),
+			 this,		SLOT(readyRead()) ) ;
+	connect( m_socket,	SIGNAL(disconnected()),
+			 this,		SLOT(disconnected()) ) ;
+
+	m_session = m_dataServer->attachSession( this ) ;		// new v3.9
+
+	m_dataServer->networkInfo( QString("Client %1 connected").arg(m_socketDescriptor) ) ;
+	return true ;
+}
+
+/*!
+ * Connecteur de réception des données client. Les données sont accumulées puis
+ * découpées en requêtes par QamAbstractServer::frameLength() : une requête
+ * répartie sur plusieurs segments TCP est traitée dès qu'elle est complète, et
+ * plusieurs requêtes reçues ensemble (pipeline) sont traitées dans l'ordre.
+ * Chaque requête est transmise au serveur "métier" qui à charge de fournir la
+ * réponse ; les réponses sont regroupées en une seule écriture.
+ */
+
+void QamTcpSession::readyRead()
+{
+	m_rxBuffer.append( m_socket->readAll() ) ;
+
+	QByteArray	responses ;
+	int			offset = 0 ;
+	int			count = 0 ;
+
+	while ( offset < m_rxBuffer.size() ) {
+		int len = m_dataServer->frameLength( m_rxBuffer.constData() + offset, m_rxBuffer.size() - offset ) ;
+		if ( len == 0 )	break ;				// requête incomplète, attente de la suite
+		if ( len < 0 ) {
+			drop( QString("Invalid frame from client %1").arg(m_socketDescriptor) ) ;
+			return ;
+		}
+		QByteArray frame = m_rxBuffer.mid( offset, len ) ;
+		responses.append( m_dataServer->responseToSessionRequest( m_session, frame ) ) ;
+		offset += len ;
+		++count ;
+	}
+
+	// seules les données d'une requête incomplète sont conservées
+	m_rxBuffer.remove( 0, offset ) ;
+
+	if ( m_rxBuffer.size() > QAMTCP_RX_MAX ) {
+		drop( QString("Receive overflow from client %1").arg(m_socketDescriptor) ) ;
+		return ;
+	}
+
+	// message par requête : journal différé plutôt que signal info() (new v3.8)
+	if ( count )	QAMTRACE( QamTrace::Debug, "tcp", "request from client %1 (%2 frames)", m_socketDescriptor, count ) ;
+	if ( !responses.isEmpty() )	m_socket->write( responses ) ;
+}
+
+/*!
+ * Connecteur de détection de la déconnexion par le client.
+ */
+
+void QamTcpSession::disconnected()
+{
+	if ( m_closed )	return ;
+	m_closed = true ;
+
+	m_dataServer->networkInfo( QString("Client %1 disconnected").arg(m_socketDescriptor) ) ;
+	release() ;
+	emit closed( m_socketDescriptor ) ;
+}
+
+/*!
+ * Fermeture de la session à l'initiative du serveur (arrêt ou changement de
+ * mode), à invoquer dans le thread de la session : la connexion est abandonnée,
+ * le signal closed() émis si nécessaire et la session détruite par la boucle
+ * d'événements de son thread (new v3.9).
+ */
+
+void QamTcpSession::close()
+{
+	if ( !m_closed ) {
+		m_closed = true ;
+		release() ;
+		emit closed( m_socketDescriptor ) ;
+	}
+	if ( m_socket )	m_socket->abort() ;
+	deleteLater() ;
+}
+
+/*!
+ * Ecriture de données émises spontanément vers le client (new v3.9), à
+ * invoquer dans le thread de la session (cf. QamAbstractServer::push()) ;
+ * sans effet si la session est close.
+ * \param data : données à émettre.
+ */
+
+void QamTcpSession::send(const QByteArray& data )
+{
+	if (( m_closed )||( !m_socket ))	return ;
+	m_socket->write( data ) ;
+}
+
+// [private] fin de session : notification du serveur "métier", puis retrait
+// du registre des sessions (aucune donnée n'est plus remise à la session)
+
+void QamTcpSession::release()
+{
+	if ( !m_session )	return ;
+	m_dataServer->sessionClosed( m_session ) ;
+	m_dataServer->detachSession( m_session ) ;
+	m_session = 0 ;
+}
+
+// [private] abandon de la connexion (flux invalide)
+
+void QamTcpSession::drop(const QString& message )
+{
+	m_dataServer->networkInfo( message ) ;
+	m_rxBuffer.clear() ;
+	m_socket->disconnectFromHost() ;
+}
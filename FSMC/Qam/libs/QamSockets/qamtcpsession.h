@@ -0,0 +1,100 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   qamtcpsession.h
+ *  description :   INTERFACE de la classe QamTcpSession
+ *
+ *	project     :	QamSockets Library
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2006-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "QamSockets Library"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#ifndef QAMTCPSESSION_H
+#define QAMTCPSESSION_H
+
+/*!
+  @file
+  @brief Session TCP côté serveur
+ */
+
+/*!
+ @class QamTcpSession
+ @brief Session TCP côté serveur.
+
+ La classe QamTcpSession prend en charge la socket d'un client connecté, son
+ tampon de réception et le découpage des requêtes (voir
+ QamAbstractServer::frameLength()). Une session ne possède pas de thread :
+ elle est servie par la boucle d'événements du thread auquel elle appartient,
+ qu'il s'agisse du thread dédié d'une QamTcpConnection ou d'un thread partagé
+ par plusieurs sessions (mode QamTcpServer::Reactor).
+
+ La socket est créée par open(), qui doit donc être invoquée dans le thread
+ de la session. Le signal closed() est émis une seule fois, en fin de
+ connexion ; la destruction de la session est à la charge de son
+ propriétaire, sauf fermeture par close() (arrêt du serveur).
+
+ Une session ouverte est enregistrée auprès du serveur "métier" sous un
+ identifiant unique (sessionId()) : les données qu'il émet spontanément vers
+ ce client (QamAbstractServer::push()) sont remises directement à la session
+ et écrites sur sa socket (send()).
+ */
+
+#include <QObject>
+#include <QTcpSocket>
+#include "qamabstractserver.h"
+
+// taille maximale des données reçues en attente d'une requête complète
+#define	QAMTCP_RX_MAX	65536		// new v3.4
+
+class QamTcpSession : public QObject
+{
+	Q_OBJECT
+
+  public:
+	explicit QamTcpSession(qintptr id, QamAbstractServer* server, QObject* parent = 0 ) ;
+	~QamTcpSession() ;
+	qintptr id() const ;
+	quint64 sessionId() const ;								// new v3.9
+
+  public slots:
+	bool open() ;
+	void close() ;											// new v3.9
+	void send(const QByteArray& data ) ;					// new v3.9
+
+  signals:
+	/*! Fin de la connexion (déconnexion du client ou flux invalide). */
+	void closed(qintptr id ) ;
+
+  private slots:
+	void readyRead() ;
+	void disconnected() ;
+
+  private:
+	void drop(const QString& message ) ;
+	void release() ;
+
+  private:
+	QTcpSocket*			m_socket ;				// socket cliente
+	qintptr				m_socketDescriptor ;
+	quint64				m_session ;				// identifiant auprès du serveur métier (0 : non enregistrée)
+	QamAbstractServer*	m_dataServer ;			// serveur métier
+	QByteArray			m_rxBuffer ;			// données reçues non traitées
+	bool				m_closed ;
+} ;
+
+#endif // QAMTCPSESSION_H
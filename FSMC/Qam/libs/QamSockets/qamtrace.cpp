@@ -0,0 +1,226 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   qamtrace.cpp
+ *  description :   IMPLEMENTATION de la classe QamTrace
+ *
+ *	project     :	QamSockets Library
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2006-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "QamSockets Library"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#include "qamtrace.h"
+#include <QThread>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QByteArray>
+
+// entrée de l'anneau ; 'seq' synchronise producteurs et thread d'écriture
+// (file bornée multi-producteurs sans verrou)
+
+struct QamTraceRecord {
+	QAtomicInteger<quint32>	seq ;
+	qint64					time ;		// ns depuis start()
+	int						level ;
+	const char*				source ;
+	const char*				format ;
+	qint64					args[4] ;
+} ;
+
+static QamTraceRecord			s_ring[ QAMTRACE_CAPACITY ] ;
+static QAtomicInteger<quint32>	s_head ;		// prochaine entrée à écrire
+static quint32					s_tail = 0 ;	// prochaine entrée à lire (thread d'écriture)
+static QAtomicInteger<quint32>	s_dropped ;
+static QElapsedTimer			s_clock ;
+static QMutex					s_control ;		// start() / stop()
+
+QAtomicInteger<int>	QamTrace::s_level( -1 ) ;
+
+// mise en forme d'une entrée (thread d'écriture uniquement)
+
+static QByteArray formatRecord(const QamTraceRecord& r )
+{
+	static const char*	levels[] = { "E", "W", "I", "D", "T" } ;
+
+	QByteArray	line ;
+	line.reserve( 128 ) ;
+	line += QByteArray::number( r.time / 1000000 ) ;
+	line += ' ' ;
+	line += levels[ qBound( 0, r.level, 4 ) ] ;
+	line += ' ' ;
+	line += r.source ;
+	line += ": " ;
+
+	for ( const char* p = r.format ; *p ; ++p ) {
+		if ( *p != '%' ) {
+			line += *p ;
+			continue ;
+		}
+		char	spec = 0 ;
+		const char* q = p + 1 ;
+		if (( *q == 'x' )||( *q == 'a' ))	spec = *q++ ;
+		if (( *q < '1' )||( *q > '4' )) {
+			line += *p ;
+			continue ;
+		}
+		qint64 v = r.args[ *q - '1' ] ;
+		if ( spec == 'x' )		line += QByteArray::number( v, 16 ).toUpper().rightJustified( 4, '0' ) ;
+		else if ( spec == 'a' )	line += QByteArray::number( ( v >> 24 ) & 0xFF ) + '.' + QByteArray::number( ( v >> 16 ) & 0xFF )
+									+ '.' + QByteArray::number( ( v >> 8 ) & 0xFF ) + '.' + QByteArray::number( v & 0xFF ) ;
+		else					line += QByteArray::number( v ) ;
+		p = q ;
+	}
+	line += '\n' ;
+	return line ;
+}
+
+// thread d'écriture : vidage périodique de l'anneau
+
+class QamTraceWriter : public QThread
+{
+  public:
+	explicit QamTraceWriter(FILE* output ) : m_output( output ), m_stop( 0 ) {}
+	void requestStop() { m_stop.storeRelaxed( 1 ) ; }
+
+  protected:
+	void run() override
+	{
+		while ( !m_stop.loadRelaxed() ) {
+			drain() ;
+			msleep( QAMTRACE_PERIOD ) ;
+		}
+		drain() ;
+	}
+
+  private:
+	void drain()
+	{
+		bool	written = false ;
+		for ( ;; ) {
+			QamTraceRecord& r = s_ring[ s_tail & ( QAMTRACE_CAPACITY - 1 ) ] ;
+			if ( r.seq.loadAcquire() != s_tail + 1 )	break ;		// anneau vide
+
+			QByteArray	line = formatRecord( r ) ;
+			r.seq.storeRelease( s_tail + QAMTRACE_CAPACITY ) ;	// entrée libérée
+			++s_tail ;
+
+			std::fwrite( line.constData(), 1, line.size(), m_output ) ;
+			written = true ;
+		}
+		if ( written )	std::fflush( m_output ) ;
+	}
+
+  private:
+	FILE*					m_output ;
+	QAtomicInt				m_stop ;
+} ;
+
+static QamTraceWriter*	s_writer = nullptr ;
+
+/*!
+ * Démarrage du journal et de son thread d'écriture.
+ * \param level : niveau maximal enregistré.
+ * \param output : flux de sortie (stdout par défaut).
+ */
+
+void QamTrace::start(Level level, FILE* output )
+{
+	QMutexLocker	lock( &s_control ) ;
+	if ( s_writer )	return ;
+
+	for ( int i = 0 ; i < QAMTRACE_CAPACITY ; ++i )	s_ring[i].seq.storeRelaxed( s_tail + i ) ;
+	s_head.storeRelaxed( s_tail ) ;
+	s_clock.start() ;
+
+	s_writer = new QamTraceWriter( output ) ;
+	s_writer->start( QThread::LowPriority ) ;
+	s_level.storeRelease( level ) ;
+}
+
+/*!
+ * Arrêt du journal : les entrées en attente sont écrites, les suivantes
+ * sont ignorées.
+ */
+
+void QamTrace::stop()
+{
+	QMutexLocker	lock( &s_control ) ;
+	if ( !s_writer )	return ;
+
+	s_level.storeRelease( -1 ) ;
+	s_writer->requestStop() ;
+	s_writer->wait() ;
+	delete s_writer ;
+	s_writer = nullptr ;
+}
+
+/*! Modification du niveau maximal enregistré (sans effet avant start()). */
+
+void QamTrace::setLevel(Level level )
+{
+	QMutexLocker	lock( &s_control ) ;
+	if ( s_writer )	s_level.storeRelease( level ) ;
+}
+
+/*! Nombre d'entrées perdues faute de place dans l'anneau. */
+
+quint32 QamTrace::dropped()
+{
+	return s_dropped.loadRelaxed() ;
+}
+
+/*!
+ * Enregistrement d'une entrée (utiliser de préférence la macro QAMTRACE(),
+ * qui évite l'appel si le niveau est filtré). Méthode utilisable depuis
+ * n'importe quel thread, sans verrou ni allocation.
+ * \param level : niveau du message.
+ * \param source : origine du message (chaîne littérale).
+ * \param format : format du message (chaîne littérale).
+ * \param a1 : premier argument (%1), etc.
+ */
+
+void QamTrace::log(int level, const char* source, const char* format, qint64 a1, qint64 a2, qint64 a3, qint64 a4 )
+{
+	if ( !isEnabled( level ) )	return ;
+
+	quint32	pos = s_head.loadRelaxed() ;
+	QamTraceRecord*	r ;
+
+	for ( ;; ) {
+		r = &s_ring[ pos & ( QAMTRACE_CAPACITY - 1 ) ] ;
+		qint32 diff = (qint32)( r->seq.loadAcquire() - pos ) ;
+		if ( diff == 0 ) {
+			if ( s_head.testAndSetRelaxed( pos, pos + 1, pos ) )	break ;	// entrée réservée
+		}
+		else if ( diff < 0 ) {
+			s_dropped.fetchAndAddRelaxed( 1 ) ;		// anneau plein
+			return ;
+		}
+		else	pos = s_head.loadRelaxed() ;
+	}
+
+	r->time = s_clock.nsecsElapsed() ;
+	r->level = level ;
+	r->source = source ;
+	r->format = format ;
+	r->args[0] = a1 ;
+	r->args[1] = a2 ;
+	r->args[2] = a3 ;
+	r->args[3] = a4 ;
+	r->seq.storeRelease( pos + 1 ) ;	// entrée publiée
+}
@@ -0,0 +1,103 @@
+/*  ---------------------------------------------------------------------------
+ *  filename    :   qamtrace.h
+ *  description :   INTERFACE de la classe QamTrace
+ *
+ *	project     :	QamSockets Library
+ *  start date  :   octobre 2026
+ *  ---------------------------------------------------------------------------
+ *  Copyright 2006-2026 by Alain Menu   <alain.menu@ac-creteil.fr>
+ *
+ *  This file is part of "QamSockets Library"
+ *
+ *  This program is free software ;  you can  redistribute it and/or  modify it
+ *  under the terms of the  GNU General Public License as published by the Free
+ *  Software Foundation ; either version 3 of the License, or  (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY ; without even the  implied  warranty  of  MERCHANTABILITY  or
+ *  FITNESS FOR  A PARTICULAR PURPOSE. See the  GNU General Public License  for
+ *  more details.
+ *
+ *	You should have  received  a copy of the  GNU General Public License  along
+ *	with this program. If not, see <http://www.gnu.org/licenses/>.
+ *  ---------------------------------------------------------------------------
+ */
+
+#ifndef QAMTRACE_H
+#define QAMTRACE_H
+
+/*!
+  @file
+  @brief Journal de diagnostic à niveaux, mise en forme différée
+ */
+
+/*!
+ @class QamTrace
+ @brief Journal de diagnostic à niveaux, mise en forme différée.
+
+ La classe QamTrace (méthodes statiques) est destinée aux messages émis
+ à chaque requête par les couches réseau et Modbus. Sur le chemin critique,
+ la macro QAMTRACE() se limite à un test de niveau puis à la copie d'une
+ entrée de taille fixe (format, arguments entiers, date) dans un anneau
+ partagé par tous les threads, sans verrou ni allocation ; la mise en forme
+ et l'écriture sont faites par un thread dédié, démarré par start().
+
+ Le niveau est filtré deux fois :
+ - à la compilation, par la macro QAMTRACE_LEVEL (les appels de niveau
+   supérieur disparaissent du code) ;
+ - à l'exécution, par setLevel() ou start() ; avant start(), rien n'est
+   enregistré.
+
+ Le format doit être une chaîne littérale (seule son adresse est conservée) ;
+ les arguments, au plus 4, sont des entiers désignés par %1 à %4 (décimal),
+ %x1 à %x4 (hexadécimal sur 4 chiffres) ou %a1 à %a4 (adresse IPv4).
+ Lorsque l'anneau est plein, les nouvelles entrées sont perdues et
+ comptées (dropped()).
+
+@code
+	QamTrace::start( QamTrace::Debug ) ;
+	...
+	QAMTRACE( QamTrace::Debug, "tcp", "request from client %1", id ) ;
+@endcode
+ */
+
+#include <QtGlobal>
+#include <QAtomicInteger>
+#include <cstdio>
+
+#ifndef QAMTRACE_LEVEL
+#define	QAMTRACE_LEVEL		4		// niveau maximal compilé (0 : Error .. 4 : Trace)
+#endif
+
+#define	QAMTRACE_CAPACITY	1024	// entrées de l'anneau (puissance de 2)
+#define	QAMTRACE_PERIOD		50		// période d'écriture du thread dédié (ms)
+
+#define	QAMTRACE(level, source, ...) \
+	do { \
+		if (( (level) <= QAMTRACE_LEVEL )&&( QamTrace::isEnabled( level ) )) \
+			QamTrace::log( (level), (source), __VA_ARGS__ ) ; \
+	} while ( 0 )
+
+class QamTrace
+{
+  public:
+	/*! Niveaux des messages, du plus grave au plus détaillé. */
+	typedef enum { Error = 0, Warning = 1, Info = 2, Debug = 3, Trace = 4 } Level ;
+
+	static void start(Level level = Info, FILE* output = stdout ) ;
+	static void stop() ;
+	static void setLevel(Level level ) ;
+	/*! Niveau courant (-1 si le journal n'est pas démarré). */
+	static inline int level() { return s_level.loadRelaxed() ; }
+	/*! Vrai si les messages de niveau @a level sont enregistrés. */
+	static inline bool isEnabled(int level ) { return level <= s_level.loadRelaxed() ; }
+	static quint32 dropped() ;
+
+	static void log(int level, const char* source, const char* format, qint64 a1 = 0, qint64 a2 = 0, qint64 a3 = 0, qint64 a4 = 0 ) ;
+
+  private:
+	static QAtomicInteger<int>	s_level ;
+} ;
+
+#endif // QAMTRACE_H
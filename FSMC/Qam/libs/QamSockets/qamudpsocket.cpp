@@ -25,6 +25,7 @@
  */
  
 #include "qamudpsocket.h"
+#include "qamtrace.h"
 #include <QCoreApplication>
 
 /*! Constructeur. */
@@ -149,7 +150,7 @@ void QamUdpSocket::sockRead()
 		QByteArray  datagram ;
 		datagram.resize( pendingDatagramSize() ) ;
 		readDatagram(datagram.data(), datagram.size(), &m_distAddr, &m_distPort ) ;
-		emit sockInfo(QString("RECV from %1:%2").arg( m_distAddr.toString() ).arg( m_distPort) ) ;
+		QAMTRACE( QamTrace::Debug, "udp", "RECV from %a1:%2", m_distAddr.toIPv4Address(), m_distPort ) ;	// new v3.8
 		emit sockReceived( datagram ) ;
 	}
 }
@@ -0,0 +1,38 @@
+QT       += core network
+QT       -= gui
+
+CONFIG   += console
+
+macx:CONFIG -= app_bundle
+
+MOC_DIR		 = .moc
+OBJECTS_DIR	 = .obj
+
+QAMSOCKETS	 = ../../libs/QamSockets
+QAMMODBUSMAP = ../../libs/QamModbusMap
+
+INCLUDEPATH +=	. $${QAMSOCKETS} $${QAMMODBUSMAP}
+
+SOURCES  += main.cpp \
+			modipbench.cpp \
+			$${QAMSOCKETS}/qamtcpserver.cpp \
+			$${QAMSOCKETS}/qamtcpconnection.cpp \
+			$${QAMSOCKETS}/qamtcpsession.cpp \
+			$${QAMSOCKETS}/qamabstractserver.cpp \
+			$${QAMSOCKETS}/qamtrace.cpp \
+			$${QAMMODBUSMAP}/qammodbusmap.cpp \
+			$${QAMMODBUSMAP}/qammodbusdata.cpp
+
+HEADERS  += modipbench.h \
+			$${QAMSOCKETS}/qamtcpserver.h \
+			$${QAMSOCKETS}/qamtcpconnection.h \
+			$${QAMSOCKETS}/qamtcpsession.h \
+			$${QAMSOCKETS}/qamabstractserver.h \
+			$${QAMSOCKETS}/qamtrace.h \
+			$${QAMMODBUSMAP}/qammodbusmap.h \
+			$${QAMMODBUSMAP}/qammodbusdata.h \
+			$${QAMMODBUSMAP}/qammodbuspdu.h
+
+TEMPLATE  = app
+DESTDIR	  =	release
+TARGET	  = modipbench
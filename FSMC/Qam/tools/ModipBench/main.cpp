@@ -0,0 +1,57 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTimer>
+#include "modipbench.h"
+
+#include <iostream>
+using namespace std ;
+
+int main(int argc, char *argv[] )
+{
+	QCoreApplication app(argc, argv ) ;
+
+	ModipBench::Options	opt ;
+
+	QCommandLineParser	parser ;
+	parser.setApplicationDescription("Modbus/TCP server load test (QamTcpServer + QamModbusMap on localhost)") ;
+	parser.addHelpOption() ;
+	parser.addOptions({
+		{ { "c", "clients" }, "concurrent clients (default 4)", "n" },
+		{ { "w", "window" }, "pipelined requests per client (default 8)", "n" },
+		{ { "r", "rate" }, "target rate in req/s for all clients, 0 for unlimited (default 0)", "rate" },
+		{ { "d", "duration" }, "measurement duration in seconds (default 10)", "s" },
+		{ { "n", "registers" }, "map size in holding registers, 1..65536 (default 1000)", "n" },
+		{ { "q", "quantity" }, "words per FC3/FC16 request, 1..123 (default 16)", "n" },
+		{ { "m", "mix" }, "function weights (default 3:40,16:20,1:20,5:20)", "mix" },
+		{ { "p", "port" }, "local server port (default 15020)", "port" },
+		{ { "t", "workers" }, "server worker threads, 0 for main thread (default 1)", "n" }
+	}) ;
+	parser.process( app ) ;
+
+	if ( parser.isSet("clients") )		opt.clients = parser.value("clients").toInt() ;
+	if ( parser.isSet("window") )		opt.window = parser.value("window").toInt() ;
+	if ( parser.isSet("rate") )			opt.rate = parser.value("rate").toDouble() ;
+	if ( parser.isSet("duration") )		opt.duration = parser.value("duration").toInt() ;
+	if ( parser.isSet("registers") )	opt.registers = parser.value("registers").toInt() ;
+	if ( parser.isSet("quantity") )		opt.quantity = parser.value("quantity").toInt() ;
+	if ( parser.isSet("port") )			opt.port = parser.value("port").toUShort() ;
+	if ( parser.isSet("workers") )		opt.workers = parser.value("workers").toInt() ;
+
+	if (( parser.isSet("mix") )&&( !ModipBench::parseMix( parser.value("mix"), opt.mix ) )) {
+		cerr << "invalid mix: " << qPrintable( parser.value("mix") ) << endl ;
+		return -1 ;
+	}
+
+	if (( opt.clients < 1 )||( opt.window < 1 )||( opt.window > 4096 )||( opt.rate < 0 )
+	  ||( opt.duration < 1 )||( opt.registers < 1 )||( opt.registers > 65536 )
+	  ||( opt.quantity < 1 )||( opt.quantity > 123 )||( opt.port == 0 )||( opt.workers < 0 )) {
+		parser.showHelp( -1 ) ;
+	}
+
+	ModipBench*	bench = new ModipBench( opt, &app ) ;
+
+	QObject::connect(bench, &ModipBench::quit, &app, [](int code ) { QCoreApplication::exit( code ) ; } ) ;
+	QTimer::singleShot(0, bench, SLOT(start()) ) ;
+
+	return app.exec() ;
+}
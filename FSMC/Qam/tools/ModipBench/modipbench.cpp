@@ -0,0 +1,567 @@
+#include "modipbench.h"
+#include <QHostAddress>
+#include <QtAlgorithms>
+#include <cmath>
+
+#include <iostream>
+using namespace std ;
+
+static const quint8		s_function[ MODIPBENCH_FC_COUNT ] = { 3, 16, 1, 5 } ;
+static const char*		s_label[ MODIPBENCH_FC_COUNT ] = { "FC3", "FC16", "FC1", "FC5" } ;
+
+#define	HISTO_LINEAR	64		// classes de 1 ns sous 64 ns
+#define	HISTO_SUB		32		// classes par puissance de 2 au-delà
+#define	HISTO_SIZE		( HISTO_LINEAR + ( 63 - 6 + 1 ) * HISTO_SUB )
+
+// ---------------------------------------------------------------------------
+// ModipBenchHistogram
+// ---------------------------------------------------------------------------
+
+ModipBenchHistogram::ModipBenchHistogram()
+	: m_buckets( HISTO_SIZE, 0 )
+	, m_count( 0 )
+	, m_sum( 0 )
+	, m_min( 0 )
+	, m_max( 0 )
+{
+}
+
+void ModipBenchHistogram::record(qint64 ns )
+{
+	if ( ns < 0 )	ns = 0 ;
+
+	m_buckets[ index( ns ) ]++ ;
+	if (( m_count == 0 )||( ns < m_min ))	m_min = ns ;
+	if ( ns > m_max )	m_max = ns ;
+	m_sum += ns ;
+	m_count++ ;
+}
+
+void ModipBenchHistogram::add(const ModipBenchHistogram& other )
+{
+	if ( other.m_count == 0 )	return ;
+
+	for ( int i = 0 ; i < HISTO_SIZE ; ++i )	m_buckets[i] += other.m_buckets[i] ;
+	if (( m_count == 0 )||( other.m_min < m_min ))	m_min = other.m_min ;
+	if ( other.m_max > m_max )	m_max = other.m_max ;
+	m_sum += other.m_sum ;
+	m_count += other.m_count ;
+}
+
+// latence (ns) en deçà de laquelle se trouvent p % des mesures
+
+qint64 ModipBenchHistogram::percentile(double p ) const
+{
+	if ( m_count == 0 )	return 0 ;
+
+	qint64	target = (qint64)std::ceil( p / 100.0 * m_count ) ;
+	if ( target < 1 )	target = 1 ;
+
+	qint64	sum = 0 ;
+	for ( int i = 0 ; i < HISTO_SIZE ; ++i ) {
+		sum += m_buckets[i] ;
+		if ( sum >= target )	return qMin( value( i ), m_max ) ;
+	}
+	return m_max ;
+}
+
+// répartition par puissance de 2 en microsecondes : rang 0 pour < 1 us,
+// rang k pour [ 2^(k-1), 2^k [ us
+
+QVector<qint64> ModipBenchHistogram::powerOfTwoCounts() const
+{
+	QVector<qint64>	counts ;
+
+	for ( int i = 0 ; i < HISTO_SIZE ; ++i ) {
+		if ( m_buckets[i] == 0 )	continue ;
+		quint64	us = value( i ) / 1000 ;
+		int		rank = ( us ? 64 - qCountLeadingZeroBits( us ) : 0 ) ;
+		if ( rank >= counts.size() )	counts.resize( rank + 1 ) ;
+		counts[ rank ] += m_buckets[i] ;
+	}
+	return counts ;
+}
+
+// [private] classe d'une mesure
+
+int ModipBenchHistogram::index(qint64 ns )
+{
+	if ( ns < HISTO_LINEAR )	return (int)ns ;
+
+	int	e = 63 - qCountLeadingZeroBits( (quint64)ns ) ;		// e >= 6
+	int	shift = e - 5 ;
+	return HISTO_LINEAR + ( e - 6 ) * HISTO_SUB + (int)( ns >> shift ) - HISTO_SUB ;
+}
+
+// [private] valeur représentative (milieu) d'une classe
+
+qint64 ModipBenchHistogram::value(int index )
+{
+	if ( index < HISTO_LINEAR )	return index ;
+
+	int		k = index - HISTO_LINEAR ;
+	int		shift = k / HISTO_SUB + 1 ;
+	qint64	sub = k % HISTO_SUB + HISTO_SUB ;
+	return ( sub << shift ) + ( ( 1LL << shift ) >> 1 ) ;
+}
+
+// ---------------------------------------------------------------------------
+// ModipBenchClient
+// ---------------------------------------------------------------------------
+
+ModipBenchClient::ModipBenchClient(int id, const QElapsedTimer* clock, QObject* parent )
+	: QObject(parent)
+	, m_id( id )
+	, m_clock( clock )
+	, m_random( 1000 + id )				// tirages reproductibles d'une mesure à l'autre
+	, m_registers( 0 )
+	, m_coils( 0 )
+	, m_quantity( 1 )
+	, m_window( 1 )
+	, m_rate( 0 )
+	, m_running( false )
+	, m_start( 0 )
+	, m_issued( 0 )
+	, m_ti( 0 )
+	, m_inflight( 0 )
+	, m_stamp( 65536, 0 )
+	, m_function( 65536, -1 )
+	, m_completed( 0 )
+{
+	for ( int i = 0 ; i < MODIPBENCH_FC_COUNT ; ++i ) {
+		m_mix[i] = 0 ;
+		m_sent[i] = 0 ;
+		m_errors[i] = 0 ;
+	}
+
+	m_socket = new QTcpSocket( this ) ;
+
+	connect( m_socket, SIGNAL(connected()), this, SIGNAL(connected()) ) ;
+	connect( m_socket, SIGNAL(readyRead()), this, SLOT(readResponses()) ) ;
+	connect( m_socket, SIGNAL(errorOccurred(QAbstractSocket::SocketError)), this, SLOT(socketError()) ) ;
+
+	m_timer = new QTimer( this ) ;
+	m_timer->setTimerType( Qt::PreciseTimer ) ;
+	m_timer->setInterval( MODIPBENCH_TICK ) ;
+
+	connect( m_timer, SIGNAL(timeout()), this, SLOT(pump()) ) ;
+}
+
+/*!
+ * Paramètres de la charge.
+ * \param mix : poids des fonctions FC3, FC16, FC1 et FC5.
+ * \param registers : nombre de mots de la table Holding Registers.
+ * \param coils : nombre de bits de la table Coils.
+ * \param quantity : nombre de mots par requête FC3 / FC16 (16 fois plus de
+ * bits pour FC1).
+ * \param window : nombre maximal de requêtes en attente de réponse.
+ * \param rate : requêtes par seconde, 0 pour une émission sans limite.
+ */
+
+void ModipBenchClient::configure(const int* mix, int registers, int coils, int quantity, int window, double rate )
+{
+	int	sum = 0 ;
+	for ( int i = 0 ; i < MODIPBENCH_FC_COUNT ; ++i ) {
+		sum += mix[i] ;
+		m_mix[i] = sum ;
+	}
+	m_registers = registers ;
+	m_coils = coils ;
+	m_quantity = qMin( quantity, registers ) ;
+	m_window = window ;
+	m_rate = rate ;
+}
+
+void ModipBenchClient::connectTo(quint16 port )
+{
+	m_socket->connectToHost( QHostAddress::LocalHost, port ) ;
+}
+
+void ModipBenchClient::start()
+{
+	m_socket->setSocketOption( QAbstractSocket::LowDelayOption, 1 ) ;
+
+	m_running = true ;
+	m_start = m_clock->nsecsElapsed() ;
+	m_timer->start() ;
+	pump() ;
+}
+
+void ModipBenchClient::stop()
+{
+	m_running = false ;
+	m_timer->stop() ;
+}
+
+// [private] émission des requêtes autorisées par la fenêtre et le rythme
+
+void ModipBenchClient::pump()
+{
+	if ( !m_running )	return ;
+
+	qint64	now = m_clock->nsecsElapsed() ;
+	qint64	count = m_window - m_inflight ;
+
+	if ( m_rate > 0 ) {
+		qint64	due = (qint64)( ( now - m_start ) * 1e-9 * m_rate ) + 1 - m_issued ;
+		count = qMin( count, due ) ;
+	}
+	if ( count <= 0 )	return ;
+
+	m_batch.resize( 0 ) ;
+
+	for ( int n = 0 ; n < count ; ++n ) {
+		int	draw = m_random.bounded( m_mix[ MODIPBENCH_FC_COUNT - 1 ] ) ;
+		int	fc = 0 ;
+		while ( draw >= m_mix[ fc ] )	fc++ ;
+
+		quint16	ti = m_ti++ ;
+
+		// à rythme imposé, la latence est comptée depuis la date d'émission
+		// prévue : l'attente due à une fenêtre pleine n'est pas masquée
+		m_stamp[ ti ] = ( m_rate > 0 ? m_start + (qint64)( m_issued * 1e9 / m_rate ) : now ) ;
+		m_function[ ti ] = fc ;
+
+		QamModbusFrame	frame ;
+		buildRequest( frame, fc, ti ) ;
+		m_batch.append( frame.constData(), frame.size() ) ;
+
+		m_issued++ ;
+		m_sent[ fc ]++ ;
+		m_inflight++ ;
+	}
+
+	m_socket->write( m_batch ) ;
+}
+
+// [private] requête de la fonction de rang 'fc', adresses tirées au hasard
+
+void ModipBenchClient::buildRequest(QamModbusFrame& frame, int fc, quint16 ti )
+{
+	frame.appendMbap( ti, 0, 0xFF ) ;
+	frame.append8( s_function[ fc ] ) ;
+
+	switch ( s_function[ fc ] ) {
+		case 3 : {
+			frame.append16( m_random.bounded( m_registers - m_quantity + 1 ) ) ;
+			frame.append16( m_quantity ) ;
+			break ;
+		}
+		case 16 : {
+			frame.append16( m_random.bounded( m_registers - m_quantity + 1 ) ) ;
+			frame.append16( m_quantity ) ;
+			frame.append8( 2 * m_quantity ) ;
+			for ( int i = 0 ; i < m_quantity ; ++i )	frame.append16( ti + i ) ;
+			break ;
+		}
+		case 1 : {
+			int	bits = qMin( 16 * m_quantity, m_coils ) ;
+			frame.append16( m_random.bounded( m_coils - bits + 1 ) ) ;
+			frame.append16( bits ) ;
+			break ;
+		}
+		case 5 : {
+			frame.append16( m_random.bounded( m_coils ) ) ;
+			frame.append16( ti & 1 ? 0xFF00 : 0x0000 ) ;
+			break ;
+		}
+	}
+	frame.updateLength() ;
+}
+
+// [private] découpage des réponses reçues et mesure des latences
+
+void ModipBenchClient::readResponses()
+{
+	m_buffer.append( m_socket->readAll() ) ;
+
+	qint64	now = m_clock->nsecsElapsed() ;
+	int		pos = 0 ;
+
+	while ( m_buffer.size() - pos > MODBUSPDU_MBAP_SIZE ) {
+		const char*	p = m_buffer.constData() + pos ;
+		int			length = 6 + QamModbusPdu::get16( p + 4 ) ;
+
+		if ( m_buffer.size() - pos < length )	break ;
+
+		quint16	ti = QamModbusPdu::get16( p ) ;
+		int		fc = m_function[ ti ] ;
+
+		if ( fc >= 0 ) {
+			if ( (quint8)p[ MODBUSPDU_MBAP_SIZE ] & 0x80 )	m_errors[ fc ]++ ;
+			else	m_histo[ fc ].record( now - m_stamp[ ti ] ) ;
+
+			m_function[ ti ] = -1 ;
+			m_inflight-- ;
+			m_completed++ ;
+		}
+		pos += length ;
+	}
+	if ( pos )	m_buffer.remove( 0, pos ) ;
+
+	// sans limite de rythme, la fenêtre est complétée à chaque réponse
+	if ( m_rate <= 0 )	pump() ;
+}
+
+void ModipBenchClient::socketError()
+{
+	emit failure( QString("client %1: %2").arg( m_id ).arg( m_socket->errorString() ) ) ;
+}
+
+// ---------------------------------------------------------------------------
+// ModipBench
+// ---------------------------------------------------------------------------
+
+/*!
+ * Décodage de la répartition des fonctions, sous la forme "3:40,16:20,1:20,5:20"
+ * (fonctions absentes de poids nul).
+ */
+
+bool ModipBench::parseMix(const QString& text, int* mix )
+{
+	int	w[ MODIPBENCH_FC_COUNT ] = { 0, 0, 0, 0 } ;
+	int	sum = 0 ;
+
+	const QStringList	entries = text.split(',', Qt::SkipEmptyParts ) ;
+	for ( const QString& entry : entries ) {
+		QStringList	field = entry.split(':') ;
+		if ( field.size() != 2 )	return false ;
+
+		bool ok1, ok2 ;
+		int	fc = field.at(0).trimmed().toInt( &ok1 ) ;
+		int	weight = field.at(1).trimmed().toInt( &ok2 ) ;
+		if ( !ok1 || !ok2 || ( weight < 0 ) )	return false ;
+
+		int	i = 0 ;
+		while (( i < MODIPBENCH_FC_COUNT )&&( s_function[i] != fc ))	i++ ;
+		if ( i == MODIPBENCH_FC_COUNT )	return false ;
+
+		w[i] = weight ;
+		sum += weight ;
+	}
+	if ( sum == 0 )	return false ;
+
+	for ( int i = 0 ; i < MODIPBENCH_FC_COUNT ; ++i )	mix[i] = w[i] ;
+	return true ;
+}
+
+ModipBench::ModipBench(const Options& options, QObject* parent )
+	: QObject(parent)
+	, m_options( options )
+	, m_server( 0 )
+	, m_connected( 0 )
+	, m_start( 0 )
+	, m_elapsed( 0 )
+	, m_lastCount( 0 )
+	, m_stopCount( 0 )
+	, m_drainStart( 0 )
+{
+	m_clock.start() ;
+
+	// cartographie Modbus
+
+	m_map = new QamModbusMap( QamModbusMap::ServerMode, this ) ;
+
+	m_map->setVerbose( false ) ;
+
+	connect( m_map, SIGNAL(info(QString,QString)), this, SLOT(info(QString,QString)) ) ;
+
+	m_progress = new QTimer( this ) ;
+	m_progress->setInterval( 1000 ) ;
+
+	connect( m_progress, SIGNAL(timeout()), this, SLOT(progress()) ) ;
+}
+
+/*!
+ * Lancement de la mesure : cartographie générée, serveur local en mode
+ * Reactor puis connexion des clients ; la charge démarre lorsque tous les
+ * clients sont connectés.
+ */
+
+void ModipBench::start()
+{
+	buildMap() ;
+
+	m_server = new QamTcpServer( m_map, this ) ;
+	m_server->setMode( QamTcpServer::Reactor, m_options.workers ) ;
+	m_server->start( m_options.port ) ;
+
+	if ( !m_server->isListening() ) {
+		emit quit( -1 ) ;
+		return ;
+	}
+
+	int	coils = qMin( m_options.registers, 9999 ) ;
+
+	for ( int i = 0 ; i < m_options.clients ; ++i ) {
+		ModipBenchClient*	client = new ModipBenchClient( i, &m_clock, this ) ;
+		client->configure( m_options.mix, m_options.registers, coils, m_options.quantity
+						 , m_options.window, m_options.rate / m_options.clients ) ;
+
+		connect( client, SIGNAL(connected()), this, SLOT(clientConnected()) ) ;
+		connect( client, SIGNAL(failure(QString)), this, SLOT(clientFailure(QString)) ) ;
+
+		m_clients << client ;
+		client->connectTo( m_options.port ) ;
+	}
+}
+
+// [private] cartographie de 'registers' mots (Holding Registers) et d'autant
+// de bits (Coils, 9999 au plus)
+
+void ModipBench::buildMap()
+{
+	for ( int i = 0 ; i < m_options.registers ; ++i ) {
+		m_map->addData( QStringList()
+			<< QString::number( 40001 + i ) << "1" << "FFFF"
+			<< QString("H%1").arg( i ) << "" << "Uint" << "0" ) ;
+	}
+
+	int	coils = qMin( m_options.registers, 9999 ) ;
+
+	for ( int i = 0 ; i < coils ; ++i ) {
+		m_map->addData( QStringList()
+			<< QString::number( 1 + i ) << "0" << "0"
+			<< QString("C%1").arg( i ) << "" << "Bool" << "0" ) ;
+	}
+}
+
+void ModipBench::info(const QString& src, const QString& msg )
+{
+	cout << qPrintable( src ) << ": " << qPrintable( msg ) << endl ;
+}
+
+void ModipBench::clientConnected()
+{
+	if ( ++m_connected < m_clients.size() )	return ;
+
+	cout << m_options.clients << " clients connected, running "
+		 << m_options.duration << " s..." << endl ;
+
+	m_start = m_clock.nsecsElapsed() ;
+	for ( ModipBenchClient* client : std::as_const( m_clients ) )	client->start() ;
+
+	m_progress->start() ;
+	QTimer::singleShot( m_options.duration * 1000, this, SLOT(stop()) ) ;
+}
+
+void ModipBench::clientFailure(const QString& message )
+{
+	// fermeture attendue des connexions en fin de mesure
+	if ( m_elapsed )	return ;
+
+	cerr << qPrintable( message ) << endl ;
+	emit quit( -1 ) ;
+}
+
+void ModipBench::progress()
+{
+	qint64	count = 0 ;
+	int		inflight = 0 ;
+	for ( ModipBenchClient* client : std::as_const( m_clients ) ) {
+		count += client->completed() ;
+		inflight += client->inflight() ;
+	}
+
+	cout << "t = " << ( m_clock.nsecsElapsed() - m_start ) / 1000000000LL << " s : "
+		 << count - m_lastCount << " req/s, " << inflight << " in flight" << endl ;
+
+	m_lastCount = count ;
+}
+
+void ModipBench::stop()
+{
+	m_progress->stop() ;
+
+	for ( ModipBenchClient* client : std::as_const( m_clients ) ) {
+		client->stop() ;
+		m_stopCount += client->completed() ;
+	}
+
+	m_elapsed = m_clock.nsecsElapsed() - m_start ;
+	m_drainStart = m_clock.nsecsElapsed() ;
+	drain() ;
+}
+
+// [private] attente des réponses aux dernières requêtes émises
+
+void ModipBench::drain()
+{
+	int	inflight = 0 ;
+	for ( ModipBenchClient* client : std::as_const( m_clients ) )	inflight += client->inflight() ;
+
+	if (( inflight )&&( m_clock.nsecsElapsed() - m_drainStart < MODIPBENCH_DRAIN * 1000000LL )) {
+		QTimer::singleShot( 10, this, SLOT(drain()) ) ;
+		return ;
+	}
+
+	report() ;
+	emit quit( 0 ) ;
+}
+
+// [private] synthèse : débit, percentiles par fonction et répartition
+
+void ModipBench::report()
+{
+	ModipBenchHistogram	histo[ MODIPBENCH_FC_COUNT ] ;
+	ModipBenchHistogram	total ;
+	qint64				sent[ MODIPBENCH_FC_COUNT ] = { 0, 0, 0, 0 } ;
+	qint64				errors[ MODIPBENCH_FC_COUNT ] = { 0, 0, 0, 0 } ;
+	qint64				allSent = 0, allErrors = 0, lost = 0 ;
+
+	for ( ModipBenchClient* client : std::as_const( m_clients ) ) {
+		for ( int fc = 0 ; fc < MODIPBENCH_FC_COUNT ; ++fc ) {
+			histo[ fc ].add( client->histogram( fc ) ) ;
+			sent[ fc ] += client->sent( fc ) ;
+			errors[ fc ] += client->errors( fc ) ;
+		}
+		lost += client->inflight() ;
+	}
+	for ( int fc = 0 ; fc < MODIPBENCH_FC_COUNT ; ++fc ) {
+		total.add( histo[ fc ] ) ;
+		allSent += sent[ fc ] ;
+		allErrors += errors[ fc ] ;
+	}
+
+	double	seconds = m_elapsed * 1e-9 ;
+
+	cout << endl ;
+	cout << qPrintable( QString::asprintf("map: %d registers, %d coils ; %d clients, window %d, %d words per request"
+			, m_options.registers, qMin( m_options.registers, 9999 ), m_options.clients
+			, m_options.window, m_options.quantity ) ) << endl ;
+	cout << qPrintable( QString::asprintf("duration: %.2f s ; sent %lld, exceptions %lld, unanswered %lld"
+			, seconds, allSent, allErrors, lost ) ) << endl ;
+	cout << qPrintable( QString::asprintf("throughput: %.1f req/s (target %s)"
+			, seconds > 0 ? m_stopCount / seconds : 0.0
+			, m_options.rate > 0 ? qPrintable( QString::number( m_options.rate ) ) : "unlimited" ) ) << endl ;
+	cout << endl ;
+
+	cout << qPrintable( QString::asprintf("%-6s %10s %10s %10s %10s %10s %10s %10s %10s"
+			, "", "count", "errors", "min", "mean", "p50", "p99", "p99.9", "max") ) << endl ;
+
+	for ( int fc = 0 ; fc <= MODIPBENCH_FC_COUNT ; ++fc ) {
+		const ModipBenchHistogram&	h = ( fc < MODIPBENCH_FC_COUNT ? histo[ fc ] : total ) ;
+		if (( fc < MODIPBENCH_FC_COUNT )&&( sent[ fc ] == 0 ))	continue ;
+
+		cout << qPrintable( QString::asprintf("%-6s %10lld %10lld %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f"
+				, fc < MODIPBENCH_FC_COUNT ? s_label[ fc ] : "all"
+				, h.count(), fc < MODIPBENCH_FC_COUNT ? errors[ fc ] : allErrors
+				, h.min() / 1000.0, h.mean() / 1000.0
+				, h.percentile( 50 ) / 1000.0, h.percentile( 99 ) / 1000.0
+				, h.percentile( 99.9 ) / 1000.0, h.max() / 1000.0 ) ) << endl ;
+	}
+	cout << "(latencies in us)" << endl << endl ;
+
+	// répartition des latences, toutes fonctions
+
+	QVector<qint64>	counts = total.powerOfTwoCounts() ;
+	qint64			peak = 1 ;
+	for ( qint64 c : std::as_const( counts ) )	peak = qMax( peak, c ) ;
+
+	for ( int k = 0 ; k < counts.size() ; ++k ) {
+		QString	range = ( k == 0 ? QString("< 1 us") : QString("%1 - %2 us").arg( 1LL << ( k - 1 ) ).arg( 1LL << k ) ) ;
+		QString	bar( (int)( 50 * counts[k] / peak ), '#' ) ;
+		cout << qPrintable( QString::asprintf("%20s %10lld  ", qPrintable( range ), counts[k] ) )
+			 << qPrintable( bar ) << endl ;
+	}
+}
@@ -0,0 +1,171 @@
+#ifndef MODIPBENCH_H
+#define MODIPBENCH_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QVector>
+#include <qammodbusmap.h>
+#include <qammodbuspdu.h>
+#include <qamtcpserver.h>
+
+#define	MODIPBENCH_FC_COUNT		4		// FC3, FC16, FC1, FC5
+#define	MODIPBENCH_TICK			1		// période d'émission des requêtes (ms)
+#define	MODIPBENCH_DRAIN		1000	// attente des dernières réponses (ms)
+
+// histogramme log-linéaire des latences (ns) : 32 classes par puissance de 2,
+// soit une résolution de 3 % environ, sans allocation pendant la mesure
+
+class ModipBenchHistogram
+{
+  public:
+	ModipBenchHistogram() ;
+
+	void record(qint64 ns ) ;
+	void add(const ModipBenchHistogram& other ) ;
+
+	inline qint64 count() const { return m_count ; }
+	inline qint64 min() const { return m_count ? m_min : 0 ; }
+	inline qint64 max() const { return m_max ; }
+	inline double mean() const { return m_count ? (double)m_sum / m_count : 0 ; }
+	qint64 percentile(double p ) const ;
+	QVector<qint64> powerOfTwoCounts() const ;
+
+  private:
+	static int index(qint64 ns ) ;
+	static qint64 value(int index ) ;
+
+  private:
+	QVector<qint64>	m_buckets ;
+	qint64			m_count ;
+	qint64			m_sum ;
+	qint64			m_min ;
+	qint64			m_max ;
+} ;
+
+// client Modbus/TCP brut : requêtes en pipeline (fenêtre de N requêtes en
+// attente de réponse), émises au rythme demandé
+
+class ModipBenchClient : public QObject
+{
+	Q_OBJECT
+
+  public:
+	ModipBenchClient(int id, const QElapsedTimer* clock, QObject* parent = 0 ) ;
+
+	void configure(const int* mix, int registers, int coils, int quantity, int window, double rate ) ;
+	void connectTo(quint16 port ) ;
+	void start() ;
+	void stop() ;
+
+	inline int inflight() const { return m_inflight ; }
+	inline qint64 sent(int fc ) const { return m_sent[fc] ; }
+	inline qint64 errors(int fc ) const { return m_errors[fc] ; }
+	inline qint64 completed() const { return m_completed ; }
+	inline const ModipBenchHistogram& histogram(int fc ) const { return m_histo[fc] ; }
+
+  signals:
+	void connected() ;
+	void failure(const QString& message ) ;
+
+  private slots:
+	void pump() ;
+	void readResponses() ;
+	void socketError() ;
+
+  private:
+	void buildRequest(QamModbusFrame& frame, int fc, quint16 ti ) ;
+
+  private:
+	int						m_id ;
+	const QElapsedTimer*	m_clock ;			// horloge commune aux clients
+	QTcpSocket*				m_socket ;
+	QTimer*					m_timer ;
+	QRandomGenerator		m_random ;
+	QByteArray				m_buffer ;			// réponses partiellement reçues
+	QByteArray				m_batch ;			// requêtes émises en une écriture
+
+	int						m_mix[ MODIPBENCH_FC_COUNT ] ;	// poids cumulés
+	int						m_registers ;
+	int						m_coils ;
+	int						m_quantity ;
+	int						m_window ;
+	double					m_rate ;			// requêtes/s, 0 : sans limite
+
+	bool					m_running ;
+	qint64					m_start ;			// début de la mesure (ns)
+	qint64					m_issued ;			// requêtes émises, toutes fonctions
+	quint16					m_ti ;
+	int						m_inflight ;
+	QVector<qint64>			m_stamp ;			// date d'émission par TI
+	QVector<qint8>			m_function ;		// fonction par TI
+
+	qint64					m_sent[ MODIPBENCH_FC_COUNT ] ;
+	qint64					m_errors[ MODIPBENCH_FC_COUNT ] ;
+	qint64					m_completed ;
+	ModipBenchHistogram		m_histo[ MODIPBENCH_FC_COUNT ] ;
+} ;
+
+class ModipBench : public QObject
+{
+	Q_OBJECT
+
+  public:
+	struct Options {
+		int			clients ;		// clients simultanés
+		int			window ;		// requêtes en attente par client
+		double		rate ;			// requêtes/s, tous clients, 0 : sans limite
+		int			duration ;		// durée de la mesure (s)
+		int			registers ;		// taille de la cartographie (mots)
+		int			quantity ;		// mots par requête FC3 / FC16
+		int			mix[ MODIPBENCH_FC_COUNT ] ;	// poids FC3, FC16, FC1, FC5
+		quint16		port ;
+		int			workers ;		// threads du serveur (mode Reactor)
+
+		Options() : clients( 4 ), window( 8 ), rate( 0 ), duration( 10 ), registers( 1000 )
+			, quantity( 16 ), port( 15020 ), workers( 1 )
+		{
+			mix[0] = 40 ; mix[1] = 20 ; mix[2] = 20 ; mix[3] = 20 ;
+		}
+	} ;
+
+	static bool parseMix(const QString& text, int* mix ) ;
+
+	explicit ModipBench(const Options& options, QObject* parent = 0 ) ;
+
+  public slots:
+	void start() ;
+
+  signals:
+	void quit(int code ) ;	// signal à émettre pour terminer l'application...
+
+  private slots:
+	void info(const QString& src, const QString& msg ) ;
+	void clientConnected() ;
+	void clientFailure(const QString& message ) ;
+	void progress() ;
+	void stop() ;
+	void drain() ;
+
+  private:
+	void buildMap() ;
+	void report() ;
+
+  private:
+	Options						m_options ;
+	QamModbusMap*				m_map ;
+	QamTcpServer*				m_server ;
+	QList<ModipBenchClient*>	m_clients ;
+	QElapsedTimer				m_clock ;
+	QTimer*						m_progress ;
+	int							m_connected ;
+	qint64						m_start ;		// début de la mesure (ns)
+	qint64						m_elapsed ;		// durée effective de la mesure (ns)
+	qint64						m_lastCount ;	// réponses à la dernière mesure de progression
+	qint64						m_stopCount ;	// réponses à la fin de la mesure
+	qint64						m_drainStart ;
+} ;
+
+#endif // MODIPBENCH_H
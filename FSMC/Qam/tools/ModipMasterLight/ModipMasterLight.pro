@@ -17,12 +17,14 @@ SOURCES  += main.cpp \
 			modipmaster.cpp \
 			$${QAMSOCKETS}/qamtcpclient.cpp \
 			$${QAMSOCKETS}/qamabstractserver.cpp \
+			$${QAMSOCKETS}/qamtrace.cpp \
 			$${QAMMODBUSMAP}/qammodbusmap.cpp \
 			$${QAMMODBUSMAP}/qammodbusdata.cpp
 
 HEADERS  += modipmaster.h \
 			$${QAMSOCKETS}/qamtcpclient.h \
 			$${QAMSOCKETS}/qamabstractserver.h \
+			$${QAMSOCKETS}/qamtrace.h \
 			$${QAMMODBUSMAP}/qammodbusmap.h \
 			$${QAMMODBUSMAP}/qammodbusdata.h
 			
@@ -17,14 +17,18 @@ SOURCES  += main.cpp \
 			modipslave.cpp \
 			$${QAMSOCKETS}/qamtcpserver.cpp \
 			$${QAMSOCKETS}/qamtcpconnection.cpp \
+			$${QAMSOCKETS}/qamtcpsession.cpp \
 			$${QAMSOCKETS}/qamabstractserver.cpp \
+			$${QAMSOCKETS}/qamtrace.cpp \
 			$${QAMMODBUSMAP}/qammodbusmap.cpp \
 			$${QAMMODBUSMAP}/qammodbusdata.cpp
 
 HEADERS  += modipslave.h \
 			$${QAMSOCKETS}/qamtcpserver.h \
 			$${QAMSOCKETS}/qamtcpconnection.h \
+			$${QAMSOCKETS}/qamtcpsession.h \
 			$${QAMSOCKETS}/qamabstractserver.h \
+			$${QAMSOCKETS}/qamtrace.h \
 			$${QAMMODBUSMAP}/qammodbusmap.h \
 			$${QAMMODBUSMAP}/qammodbusdata.h
 
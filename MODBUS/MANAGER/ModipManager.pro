@@ -41,8 +41,8 @@ macx:ICON = ../../../_am/icons/qam47.icns
 
 # QamSockets / QamModbusMap libraries
 
-include(../../libs/QamSockets/qamsockets.pri)
-include(../../libs/QamModbusMap/qammodbusmap.pri)
+include(../../FSMC/Qam/libs/QamSockets/qamsockets.pri)
+include(../../FSMC/Qam/libs/QamModbusMap/qammodbusmap.pri)
 
 # ModipManager files
 
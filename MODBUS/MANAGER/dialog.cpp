@@ -88,13 +88,41 @@ void Dialog::on_pbuNew_clicked()
 
 		connect( map, SIGNAL(info(QString,QString)),
 				 this, SLOT(info(QString,QString)) ) ;
+		connect( map, SIGNAL(valuesChanged(int,QStringList)),
+				 this, SLOT(valuesChanged(int,QStringList)) ) ;
 
 		map->loadMap( fileName ) ;
 		viewer->setModbusMap( map ) ;
 
+		// groupes de scrutation (new 2.4) : chaque table est lue en quelques
+		// requêtes de bloc par "Read all"
+
+		QList<int>	groups ;
+		for ( int t = QamModbusMap::Coil ; t <= QamModbusMap::HoldingRegister ; ++t ) {
+			int group = map->addPollTable( (QamModbusMap::PrimaryTable)t ) ;
+			if ( group != -1 )	groups << group ;
+		}
+
+		// canal de notification (new 2.4) : abonnement à l'ensemble des tables,
+		// les valeurs modifiées sont appliquées à la carte sans scrutation
+
+		QamModbusPushClient* push = new QamModbusPushClient(map, this ) ;
+		for ( int t = QamModbusMap::Coil ; t <= QamModbusMap::HoldingRegister ; ++t ) {
+			QamModbusMap::PrimaryTable table = (QamModbusMap::PrimaryTable)t ;
+			int count = 0 ;
+			foreach(QString name, map->nameList( table ) ) {
+				QamModbusMap::Handle h = map->handle(table, name ) ;
+				if ( h.isValid() )	count = qMax( count, h.address + h.words ) ;
+			}
+			if ( count )	push->subscribe(table, 0, count ) ;
+		}
+
 		m_modbusMap << map ;
 		m_tcpCLient << client ;
 		m_modbusMapViewer << viewer ;
+		m_pushClient << push ;
+		m_pollGroups << groups ;
+		m_pushTcpClient << new QamTcpClient(push, this ) ;
 
 		// création nouvel onglet
 
@@ -117,6 +145,7 @@ void Dialog::on_pbuConnect_clicked()
 	bool connected = m_tcpCLient.at( index )->state() == QAbstractSocket::ConnectedState ;
 	if ( connected ) {
 		m_tcpCLient.at( index )->sockClose() ;
+		m_pushTcpClient.at( index )->sockClose() ;	// new 2.4
 		pbuConnect->setText("Connect") ;
 		pbuReadAll->setEnabled( false ) ;
 		pbuRead->setEnabled( false ) ;
@@ -134,6 +163,10 @@ void Dialog::on_pbuConnect_clicked()
 
 		m_tcpCLient.at( index )->sockConnect(host, port ) ;
 		if ( m_tcpCLient.at( index )->waitForConnected(3000) ) {
+			// canal de notification facultatif : sans lui (serveur Modbus
+			// standard), la connexion échoue et seule la lecture est disponible
+			m_pushTcpClient.at( index )->sockConnect(host, port + MODBUSPUSH_PORT_OFFSET ) ;	// new 2.4
+
 			pbuConnect->setText("Close") ;
 			pbuReadAll->setEnabled( true ) ;
 			pbuRead->setEnabled( true ) ;
@@ -185,30 +218,16 @@ void Dialog::on_pbuReset_clicked()
 }
 
 // demande d'actualisation de toutes les données
-// par interrogations du serveur
+// par scrutation des groupes de l'onglet (une requête par plage d'adresses,
+// sans attente : les valeurs modifiées sont signalées par valuesChanged())
 
 void Dialog::on_pbuReadAll_clicked()
 {
 	int i = tabWidget->currentIndex() ;
 	if ( i < 0 )	return ;
 
-	QamModbusMap::PrimaryTable	table ;
-
-	table = QamModbusMap::Coil ;
-	foreach(QString name, m_modbusMap.at(i)->nameList( table ) ) {
-		m_modbusMap.at(i)->remoteValue(table, name ) ;
-	}
-	table = QamModbusMap::DiscretInput ;
-	foreach(QString name, m_modbusMap.at(i)->nameList( table ) ) {
-		m_modbusMap.at(i)->remoteValue(table, name ) ;
-	}
-	table = QamModbusMap::InputRegister ;
-	foreach(QString name, m_modbusMap.at(i)->nameList( table ) ) {
-		m_modbusMap.at(i)->remoteValue(table, name ) ;
-	}
-	table = QamModbusMap::HoldingRegister ;
-	foreach(QString name, m_modbusMap.at(i)->nameList( table ) ) {
-		m_modbusMap.at(i)->remoteValue(table, name ) ;
+	foreach(int group, m_pollGroups.at(i) ) {
+		m_modbusMap.at(i)->pollRemote( group ) ;
 	}
 }
 
@@ -249,8 +268,12 @@ void Dialog::on_tabWidget_tabCloseRequested(int index )
 {
 	bool connected = m_tcpCLient.at( index )->state() == QAbstractSocket::ConnectedState ;	// new 1.1
 	if ( connected ) m_tcpCLient.at( index )->sockClose() ;
+	m_pushTcpClient.at( index )->sockClose() ;								// new 2.4
 
 	m_tcpCLient.removeAt( index ) ;
+	m_pushTcpClient.removeAt( index ) ;
+	m_pushClient.removeAt( index ) ;
+	m_pollGroups.removeAt( index ) ;
 
 	m_modbusMapViewer.removeAt( index ) ;
 	m_modbusMap.removeAt( index ) ;
@@ -304,6 +327,14 @@ void Dialog::valueChanged(int table,const QString& name )
 	showMessage( QamModbusMap::tableAsString( (QamModbusMap::PrimaryTable)table ) + " / " + name + " changed\n", false, Qt::darkRed  ) ;
 }
 
+// données modifiées, reçues par le canal de notification (new 2.4)
+
+void Dialog::valuesChanged(int table, const QStringList& names )
+{
+	showPrompt( "values : ") ;
+	showMessage( QamModbusMap::tableAsString( (QamModbusMap::PrimaryTable)table ) + " / " + names.join(", ") + " changed\n", false, Qt::darkRed  ) ;
+}
+
 void Dialog::showPrompt(const QString& prompt )
 {
 	edtDialog->moveCursor(QTextCursor::End ) ;
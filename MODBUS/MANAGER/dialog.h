@@ -57,6 +57,7 @@ class Dialog : public QDialog, private Ui::Dialog
 	void on_tabWidget_tabCloseRequested(int index ) ;
 	void info(const QString& source, const QString& message ) ;
 	void valueChanged(int table,const QString& name ) ;
+	void valuesChanged(int table, const QStringList& names ) ;		// new 2.4
 
   private:
 	void readSettings() ;
@@ -70,6 +71,9 @@ class Dialog : public QDialog, private Ui::Dialog
 	QList<QamModbusMap *>		m_modbusMap ;
 	QList<QamTcpClient *>		m_tcpCLient ;
 	QList<QamModbusMapViewer *>	m_modbusMapViewer ;
+	QList<QamModbusPushClient *>	m_pushClient ;				// new 2.4
+	QList< QList<int> >				m_pollGroups ;				// new 2.4 (une table par groupe)
+	QList<QamTcpClient *>			m_pushTcpClient ;
 } ;
 
 #endif // DIALOG_H
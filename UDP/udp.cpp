@@ -12,6 +12,7 @@ UDP::UDP(QWidget *parent)
 {
 
     ui->setupUi(this);
+    buffer.resize(2048);//tampon alloue une seule fois
     socket = new QUdpSocket(this);
     socket->bind(QHostAddress("192.168.0.103"), 49000);
 
@@ -42,12 +43,24 @@ void UDP::traitementDatagram()
 {
     bool isdebug = false ; // variable activation debug
 
-    QHostAddress sender;
-    u_int16_t port;
+    QByteArray datagram ;//pose la plus recente du lot
 
-    QByteArray datagram ;
-    datagram.resize(socket->pendingDatagramSize());
-    socket->readDatagram(datagram.data(),datagram.size(),&sender,&port);
+    while(socket->hasPendingDatagrams()){//lecture de tous les datagrammes en attente
+        qint64 size = socket->readDatagram(buffer.data(),buffer.size());
+        if(size < 0) break;
+        recus++;
+
+        if(size < 45 || buffer.startsWith("RPOS") == false){//datagramme inconnu ou tronque
+            rejetes++;
+            continue;
+        }
+        if(datagram.isEmpty() == false) perimes++;//la pose precedente du lot est perimee
+        datagram = buffer.left(int(size));
+    }
+
+    if(isdebug == true )qDebug() << "recus" << recus << "rejetes" << rejetes << "perimes" << perimes;
+
+    if(datagram.isEmpty()) return;//aucune pose exploitable dans le lot
 
         if(isdebug == true )qDebug() << datagram;
 
@@ -25,6 +25,10 @@ signals:
 private:
     Ui::UDP *ui;
      QUdpSocket *socket = nullptr;
+     QByteArray buffer;             // tampon de reception reutilise
+     quint32 recus = 0;             // datagrammes lus
+     quint32 rejetes = 0;           // datagrammes non RPOS ou trop courts
+     quint32 perimes = 0;           // poses ecartees au profit d'une plus recente
      void change(float);
 };
 #endif // UDP_H